@@ -0,0 +1,176 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include "bucketprio.h"
+
+/* IMPLEMENTATION OF bucketprio.h */
+
+
+/* number of 64 bit words needed for n bits */
+static int wordsFor(int n){
+    return (n + 63) / 64;
+}
+
+
+/* see bucketprio.h */
+BucketPrio::BucketPrio(int maxkey, int maxitems){
+    MAXKEY = (maxkey < 0 ? 0 : maxkey);
+    MAXITEMS = (maxitems < 1 ? 1 : maxitems);
+    currentSize = 0;
+
+    head = new int[MAXKEY + 1];
+    for(int k = 0; k <= MAXKEY; k++){
+        head[k] = -1;
+    }
+    next = new int[MAXITEMS];
+    prev = new int[MAXITEMS];
+    key = new int[MAXITEMS];
+    for(int i = 0; i < MAXITEMS; i++){
+        next[i] = prev[i] = key[i] = -1;
+    }
+
+    //level 0 has a bit per bucket, each further level a bit per word below it
+    levels = 1;
+    for(int n = wordsFor(MAXKEY + 1); n > 1; n = wordsFor(n)){
+        levels++;
+    }
+    bits = new unsigned long long*[levels];
+    int n = MAXKEY + 1;
+    for(int l = 0; l < levels; l++){
+        n = wordsFor(n);
+        bits[l] = new unsigned long long[n];
+        for(int w = 0; w < n; w++){
+            bits[l][w] = 0;
+        }
+    }
+}
+
+
+/* see bucketprio.h */
+BucketPrio::~BucketPrio(){
+    for(int l = 0; l < levels; l++){
+        delete[] bits[l];
+    }
+    delete[] bits;
+    delete[] head;
+    delete[] next;
+    delete[] prev;
+    delete[] key;
+}
+
+
+/* see bucketprio.h */
+void BucketPrio::clear(){
+    for(int i = 0; i < MAXITEMS && currentSize > 0; i++){
+        if(key[i] != -1){
+            unlink(i);
+            currentSize--;
+        }
+    }
+}
+
+
+/* see bucketprio.h */
+int BucketPrio::maxKey(){
+    return MAXKEY;
+}
+
+
+/* see bucketprio.h */
+int BucketPrio::maxItems(){
+    return MAXITEMS;
+}
+
+
+/* put item at the front of bucket k, and mark the bucket in the bitmaps */
+void BucketPrio::link(int item, int k){
+    key[item] = k;
+    prev[item] = -1;
+    next[item] = head[k];
+    if(head[k] != -1){
+        prev[head[k]] = item;
+    }
+    head[k] = item;
+
+    //set the bit of bucket k and of every word above it
+    int b = k;
+    for(int l = 0; l < levels; l++){
+        unsigned long long mask = 1ULL << (b % 64);
+        bool wasEmpty = (bits[l][b / 64] == 0);
+        bits[l][b / 64] |= mask;
+        if(!wasEmpty){
+            break;
+        }
+        b = b / 64;
+    }
+}
+
+
+/* take item out of its bucket, and clear bitmap bits that became empty */
+void BucketPrio::unlink(int item){
+    int k = key[item];
+    if(prev[item] != -1){
+        next[prev[item]] = next[item];
+    }else{
+        head[k] = next[item];
+    }
+    if(next[item] != -1){
+        prev[next[item]] = prev[item];
+    }
+    next[item] = prev[item] = key[item] = -1;
+
+    if(head[k] != -1){
+        return;
+    }
+    int b = k;
+    for(int l = 0; l < levels; l++){
+        bits[l][b / 64] &= ~(1ULL << (b % 64));
+        if(bits[l][b / 64] != 0){
+            break;
+        }
+        b = b / 64;
+    }
+}
+
+
+/* see bucketprio.h */
+bool BucketPrio::enqueue(int item, int k){
+    if(item < 0 || item >= MAXITEMS || k < 0 || k > MAXKEY || key[item] != -1){
+        return false;
+    }
+    link(item, k);
+    currentSize++;
+    return true;
+}
+
+
+/* see bucketprio.h */
+bool BucketPrio::nonempty(){
+    return currentSize > 0;
+}
+
+
+/* see bucketprio.h */
+int BucketPrio::dequeueMin(){
+    if(currentSize < 1){
+        return -1;
+    }
+    //walk down from the single top word, taking the lowest set bit each time
+    int w = 0;
+    for(int l = levels - 1; l >= 0; l--){
+        w = w * 64 + __builtin_ctzll(bits[l][w]);
+    }
+    int item = head[w];
+    unlink(item);
+    currentSize--;
+    return item;
+}
+
+
+/* see bucketprio.h */
+void BucketPrio::decreasedKey(int item, int newkey){
+    if(newkey == key[item]){
+        return;
+    }
+    unlink(item);
+    link(item, newkey);
+}
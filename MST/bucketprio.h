@@ -0,0 +1,82 @@
+#ifndef bucketprio_H
+#define bucketprio_H
+
+/* min-priority queue for small nonnegative integer keys (a bucket queue)
+ *
+ * Items are the ints 0 .. maxitems-1 (for Prim's, the vertex numbers) and
+ * keys are the ints 0 .. maxkey.  There is one bucket per key; a bucket is a
+ * doubly linked list of items kept in plain arrays, so enqueue and decreasedKey
+ * are O(1) and nothing is allocated after construction.
+ *
+ * To find the smallest nonempty bucket without scanning, the queue keeps a
+ * hierarchy of occupancy bitmaps: bit b of level 0 is set when bucket b is
+ * nonempty, and bit w of level l+1 is set when word w of level l is nonzero.
+ * The top level is a single 64 bit word, so dequeueMin costs one count-trailing-
+ * zeros per level, i.e. O(log_64 maxkey).
+ *
+ * Unlike a monotone radix heap, keys may go below the last dequeued key, which
+ * is what Prim's needs (the keys it dequeues are not sorted).
+ */
+
+class BucketPrio{
+
+ public:
+
+  /* make an empty queue for items 0 .. maxitems-1 with keys 0 .. maxkey.
+   * If maxitems < 1 or maxkey < 0, they are raised to 1 and 0.
+   */
+  BucketPrio(int maxkey, int maxitems);
+
+
+  /* dispose of the memory owned by the queue */
+  ~BucketPrio();
+
+
+  /* empty the queue, so it can be used again (allocates nothing) */
+  void clear();
+
+
+  /* the largest key and the number of items the queue was made for */
+  int maxKey();
+  int maxItems();
+
+
+  /* enqueue item with the given key.
+   * Returns false (and does nothing) if item or key is out of range,
+   * or if item is already in the queue.
+   */
+  bool enqueue(int item, int key);
+
+
+  /* true if queue has elements, else false */
+  bool nonempty();
+
+
+  /* dequeue and return an item with the minimum key.
+   * If queue is empty, return -1.
+   */
+  int dequeueMin();
+
+
+  /* lower the key of an enqueued item to newkey.
+   * Assumes item is in the queue and 0 <= newkey <= its current key.
+   */
+  void decreasedKey(int item, int newkey);
+
+
+ private:
+  void link(int item, int key);   //put item at the front of bucket key
+  void unlink(int item);          //take item out of its bucket
+
+  int MAXKEY;       //largest allowed key
+  int MAXITEMS;     //items are 0 .. MAXITEMS-1
+  int currentSize;  //how many items are currently in the queue
+  int* head;        //head[k] is the first item in bucket k, or -1
+  int* next;        //next[i] is the item after i in its bucket, or -1
+  int* prev;        //prev[i] is the item before i in its bucket, or -1
+  int* key;         //key[i] is the key of item i, or -1 if i is not enqueued
+  int levels;                  //number of bitmap levels
+  unsigned long long** bits;   //bits[l] is the occupancy bitmap of level l
+};
+
+#endif
@@ -0,0 +1,164 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <vector>
+#include "builder.h"
+
+/* IMPLEMENTATION OF builder.h */
+
+
+/* see builder.h */
+template <typename W>
+GraphBuilder<W>::GraphBuilder(int n){
+    numVertices = (n < 1) ? 1 : n;
+    newest.store(NULL);
+}
+
+
+/* see builder.h */
+template <typename W>
+GraphBuilder<W>::~GraphBuilder(){
+    Buffer* b = newest.load();
+    while(b != NULL){
+        Buffer* next = b->next;
+        delete b;
+        b = next;
+    }
+}
+
+
+/* see builder.h */
+template <typename W>
+typename GraphBuilder<W>::Buffer* GraphBuilder<W>::buffer(){
+    Buffer* b = new Buffer;
+    b->next = newest.load(std::memory_order_relaxed);
+    while(!newest.compare_exchange_weak(b->next, b, std::memory_order_release,
+                                        std::memory_order_relaxed)){
+        //b->next was reloaded with the current newest; try again
+    }
+    return b;
+}
+
+
+/* number of buffers handed out */
+template <typename W>
+int GraphBuilder<W>::numBuffers(){
+    int count = 0;
+    for(Buffer* b = newest.load(std::memory_order_acquire); b != NULL; b = b->next){
+        count++;
+    }
+    return count;
+}
+
+
+/* the buffers, oldest first (the list runs from the newest) */
+template <typename W>
+void GraphBuilder<W>::listBuffers(Buffer** out){
+    int count = numBuffers();
+    for(Buffer* b = newest.load(std::memory_order_acquire); b != NULL; b = b->next){
+        out[--count] = b;
+    }
+}
+
+
+/* see builder.h */
+template <typename W>
+unique_ptr<BasicGraph<W> > GraphBuilder<W>::freeze(int rep, bool symmetric){
+    unique_ptr<BasicGraph<W> > g(new BasicGraph<W>(numVertices, rep));
+    int count = numBuffers();
+    Buffer** buffers = new Buffer*[count];
+    listBuffers(buffers);
+    if(count == 1){
+        std::vector<Edge>& edges = buffers[0]->edges;
+        g->addEdges(edges.data(), (int)edges.size(), symmetric);
+        std::vector<Edge>().swap(edges);
+    }else if(count > 1){
+        //one addEdges for all the buffers, since each call costs O(V) on
+        //top of its edges; each buffer is freed as soon as it is copied
+        size_t total = 0;
+        for(int i = 0; i < count; i++){
+            total += buffers[i]->edges.size();
+        }
+        std::vector<Edge> all;
+        all.reserve(total);
+        for(int i = 0; i < count; i++){
+            all.insert(all.end(), buffers[i]->edges.begin(), buffers[i]->edges.end());
+            std::vector<Edge>().swap(buffers[i]->edges);
+        }
+        g->addEdges(all.data(), (int)all.size(), symmetric);
+    }
+    delete[] buffers;
+    return g;
+}
+
+
+/* see builder.h */
+template <typename W>
+unique_ptr<CompressedGraph<W> > GraphBuilder<W>::freezeCompressed(bool symmetric, int weightBits){
+    int count = numBuffers();
+    Buffer** buffers = new Buffer*[count];
+    listBuffers(buffers);
+
+    //bucket the edges addEdges would accept by source, in buffer order,
+    //straight from the buffers, freeing each once its edges are placed
+    int* start = new int[numVertices + 1];
+    for(int v = 0; v <= numVertices; v++){
+        start[v] = 0;
+    }
+    for(int i = 0; i < count; i++){
+        for(const Edge& e : buffers[i]->edges){
+            if(validEdge(e)){
+                start[e.source + 1]++;
+                if(symmetric){
+                    start[e.target + 1]++;
+                }
+            }
+        }
+    }
+    for(int v = 0; v < numVertices; v++){
+        start[v + 1] += start[v];
+    }
+    int* fill = new int[numVertices];
+    for(int v = 0; v < numVertices; v++){
+        fill[v] = start[v];
+    }
+    int* targets = new int[start[numVertices]];
+    W* weights = new W[start[numVertices]];
+    for(int i = 0; i < count; i++){
+        for(const Edge& e : buffers[i]->edges){
+            if(validEdge(e)){
+                targets[fill[e.source]] = e.target;
+                weights[fill[e.source]++] = e.weight;
+                if(symmetric){
+                    targets[fill[e.target]] = e.source;
+                    weights[fill[e.target]++] = e.weight;
+                }
+            }
+        }
+        std::vector<Edge>().swap(buffers[i]->edges);
+    }
+    delete[] fill;
+    delete[] buffers;
+
+    unique_ptr<CompressedGraph<W> > g(
+        new CompressedGraph<W>(numVertices, start, targets, weights, weightBits));
+    delete[] weights;
+    delete[] targets;
+    delete[] start;
+    return g;
+}
+
+
+/* true if addEdge would take e (an edge already there aside) */
+template <typename W>
+bool GraphBuilder<W>::validEdge(const Edge& e){
+    return e.source >= 0 && e.source < numVertices && e.target >= 0 && e.target < numVertices
+           && !(e.weight < 0) && e.weight != WeightTraits<W>::noEdge();
+}
+
+
+/* the weight types GraphBuilder is compiled for, same as BasicGraph in graph.cpp */
+template class GraphBuilder<float>;
+template class GraphBuilder<double>;
+template class GraphBuilder<uint16_t>;
+template class GraphBuilder<uint32_t>;
+template class GraphBuilder<int64_t>;
@@ -0,0 +1,92 @@
+#ifndef BUILDER_H
+#define BUILDER_H
+
+#include "graph.h"
+#include "compressed.h"
+#include <atomic>
+#include <vector>
+
+/* Building a graph from many threads at once.
+ *
+ * BasicGraph::addEdge is not thread safe, so threads that find edges in
+ * parallel (parsers, generators) would have to take turns on one graph.
+ * A GraphBuilder instead gives each thread its own Buffer, which it fills
+ * with no locking or atomics at all; getting a Buffer is one lock-free push.
+ * freeze() then puts everything into a graph with one addEdges, O(V + E)
+ * (see graph.h), or into a CompressedGraph.
+ *
+ *     GraphBuilder<float> builder(n);
+ *     // on each thread:
+ *     GraphBuilder<float>::Buffer* mine = builder.buffer();
+ *     mine->add(s, t, w); ...
+ *     // after joining the threads:
+ *     unique_ptr<Graph> g = builder.freeze(ULIST, false);
+ *
+ * The result is as if the buffers were passed to addEdges one after the
+ * other, in the order they were handed out: invalid edges are skipped and
+ * of several edges between the same vertices the first one wins, so when
+ * two threads add the same edge, which weight is kept is not specified.
+ */
+
+template <typename W>
+class GraphBuilder {
+
+ public:
+  typedef typename BasicGraph<W>::Edge Edge;
+
+  /* The edges of one thread.  Only the thread that took it may use it.
+   * Aligned to a cache line so that two threads' buffers never share one.
+   */
+  class alignas(64) Buffer {
+   public:
+    /* add the edge source -> target with weight w (checked at freeze) */
+    void add(int source, int target, W w){
+      Edge e = {source, target, w};
+      edges.push_back(e);
+    }
+
+    /* number of edges added since the last freeze */
+    size_t size(){ return edges.size(); }
+
+   private:
+    friend class GraphBuilder;
+    std::vector<Edge> edges;
+    Buffer* next;       //the buffer handed out before this one, or NULL
+  };
+
+  /* a builder for a graph of n vertices (raised to 1 if n < 1) */
+  GraphBuilder(int n);
+
+  /* dispose of the buffers (any Buffer pointers become invalid) */
+  ~GraphBuilder();
+
+  /* Return a new empty Buffer.  Safe to call from any number of threads at
+   * the same time; each thread should call it once and keep its buffer.
+   */
+  Buffer* buffer();
+
+  /* Make a graph of representation rep from the edges of all the buffers,
+   * with each edge S->T followed by T->S if symmetric (as addEdges does).
+   * The buffers are emptied, but stay valid for building the next graph.
+   * No thread may be adding edges while freeze runs.
+   */
+  unique_ptr<BasicGraph<W> > freeze(int rep, bool symmetric);
+
+  /* Same, into a read-only CompressedGraph (see compressed.h), for the
+   * graphs that are too big for a BasicGraph.
+   */
+  unique_ptr<CompressedGraph<W> > freezeCompressed(bool symmetric, int weightBits);
+
+ private:
+  GraphBuilder(const GraphBuilder&) = delete;
+  GraphBuilder& operator=(const GraphBuilder&) = delete;
+
+  int numBuffers();
+  void listBuffers(Buffer** out);   //in the order handed out
+  bool validEdge(const Edge& e);    //would addEdge take e
+
+  int numVertices;
+  std::atomic<Buffer*> newest;      //the last buffer handed out, or NULL
+};
+
+#endif
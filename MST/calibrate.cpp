@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include "graph.h"
+#include "dispatch.h"
+
+/*
+ * Calibration benchmark for the thresholds of computeMST (see dispatch.h).
+ *
+ * Times every engine on random connected graphs (a random path through all
+ * vertices plus random edges) over a range of densities, finds where one
+ * engine overtakes the other, and prints the MST_* defines to paste into
+ * dispatch.h.  Takes a minute or so.  Build and run with
+ *
+ *   g++ -O2 calibrate.cpp minprio.cpp bucketprio.cpp graph.cpp primmst.cpp dispatch.cpp parallelprim.cpp -pthread -o calibrate
+ *   ./calibrate
+ */
+
+
+/* n vertices, about degree*n directed edges (both directions of each),
+ weights uniform in [1, 1000], whole numbers if integral, in representation rep */
+template <typename W>
+static unique_ptr<BasicGraph<W> > randomGraph(int n, double degree, bool integral, int rep,
+                                              unsigned seed){
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    std::uniform_real_distribution<double> weight(1, 1000);
+    std::vector<int> order(n);
+    for(int v = 0; v < n; v++){
+        order[v] = v;
+    }
+    std::shuffle(order.begin(), order.end(), random);
+
+    std::vector<typename BasicGraph<W>::Edge> edges;
+    long long wanted = (long long)(degree * n / 2);
+    for(long long i = 0; i < wanted; i++){
+        typename BasicGraph<W>::Edge e;
+        if(i < n - 1){
+            e.source = order[i];
+            e.target = order[i + 1];
+        }else{
+            e.source = vertex(random);
+            e.target = vertex(random);
+            if(e.source == e.target){
+                continue;
+            }
+        }
+        double w = weight(random);
+        e.weight = integral ? (W)(int)w : (W)w;
+        edges.push_back(e);
+    }
+    unique_ptr<BasicGraph<W> > g(new BasicGraph<W>(n, LIST));
+    g->addEdges(edges.data(), (int)edges.size(), true);
+    return (rep == LIST) ? std::move(g) : g->cloneGraph(rep);
+}
+
+
+/* best of three runs of engine on g, in seconds */
+template <typename W>
+static double timeEngine(const BasicGraph<W>* g, int engine){
+    double best = 0;
+    for(int run = 0; run < 3; run++){
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        unique_ptr<BasicGraph<W> > tree = runEngine(g, engine);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if(run == 0 || seconds < best){
+            best = seconds;
+        }
+    }
+    return best;
+}
+
+
+/* The largest average degree at which Kruskal's still beats Prim's on the
+ given queue engine, for sparse graphs of n vertices. */
+template <typename W>
+static double kruskalCrossover(int n, int prim, bool integral){
+    static const double degrees[] = {2, 3, 4, 6, 8, 12, 16, 24, 32};
+    double last = 0;
+    printf("%10s %12s %12s   (n = %d, %s weights, LIST)\n", "degree", engineName(MST_KRUSKAL),
+           engineName(prim), n, integral ? "integral" : "real");
+    for(int i = 0; i < (int)(sizeof(degrees) / sizeof(degrees[0])); i++){
+        unique_ptr<BasicGraph<W> > g = randomGraph<W>(n, degrees[i], integral, LIST, 1000 + i);
+        double k = timeEngine(g.get(), MST_KRUSKAL);
+        double p = timeEngine(g.get(), prim);
+        printf("%10g %12.4f %12.4f\n", degrees[i], k, p);
+        if(k > p){
+            break;
+        }
+        last = degrees[i];
+    }
+    return last;
+}
+
+
+/* The smallest fraction of all possible edges at which Prim's without a
+ queue beats Prim's on the heap, for MATRIX graphs of n vertices. */
+static double denseCrossover(int n){
+    static const double fractions[] = {0.01, 0.02, 0.05, 0.1, 0.15, 0.2, 0.3, 0.5, 0.8};
+    int count = (int)(sizeof(fractions) / sizeof(fractions[0]));
+    printf("%10s %12s %12s   (n = %d, real weights, MATRIX)\n", "fraction", engineName(MST_PRIM_DENSE),
+           engineName(MST_PRIM_HEAP), n);
+    for(int i = 0; i < count; i++){
+        //random edges repeat, so ask for more to get about the fraction wanted
+        double p = fractions[i];
+        double degree = -log(1 - p) * (n - 1);
+        unique_ptr<BasicGraph<float> > g = randomGraph<float>(n, degree, false, MATRIX, 2000 + i);
+        double d = timeEngine(g.get(), MST_PRIM_DENSE);
+        double h = timeEngine(g.get(), MST_PRIM_HEAP);
+        printf("%10g %12.4f %12.4f\n", p, d, h);
+        if(d < h){
+            return p;
+        }
+    }
+    return 1.0;
+}
+
+
+/* The fewest edges at which parallel Prim's on all hardware threads beats
+ the faster of Kruskal's and Prim's on the heap, for graphs of average
+ degree 8; MST_PARALLEL_NEVER if it never does, and the old value if there
+ is only one hardware thread. */
+static long long parallelCrossover(){
+    int threads = (int)std::thread::hardware_concurrency();
+    if(threads <= 1){
+        printf("one hardware thread: parallel Prim's not calibrated\n");
+        return MST_PARALLEL_MIN_EDGES;
+    }
+    static const int sizes[] = {25000, 100000, 400000, 1600000};
+    printf("%10s %12s %12s   (%d threads, degree 8, real weights, LIST)\n", "edges",
+           engineName(MST_PARALLEL), "sequential", threads);
+    for(int i = 0; i < (int)(sizeof(sizes) / sizeof(sizes[0])); i++){
+        unique_ptr<BasicGraph<float> > g = randomGraph<float>(sizes[i], 8, false, LIST, 3000 + i);
+        long long edges = 0;
+        for(int v = 0; v < sizes[i]; v++){
+            edges += g->outDegree(v);
+        }
+        double p = timeEngine(g.get(), MST_PARALLEL);
+        double s = std::min(timeEngine(g.get(), MST_KRUSKAL), timeEngine(g.get(), MST_PRIM_HEAP));
+        printf("%10lld %12.4f %12.4f\n", edges, p, s);
+        if(p < s){
+            return edges;
+        }
+    }
+    return MST_PARALLEL_NEVER;
+}
+
+
+int main(int argc, char** argv){
+    double kruskalReal = kruskalCrossover<float>(200000, MST_PRIM_HEAP, false);
+    printf("\n");
+    double kruskalIntegral = kruskalCrossover<uint32_t>(200000, MST_PRIM_BUCKET, true);
+    printf("\n");
+    double dense = denseCrossover(3000);
+    printf("\n");
+    long long parallel = parallelCrossover();
+    printf("\n");
+
+    printf("#define MST_DENSE_FRACTION %g\n", dense);
+    printf("#define MST_KRUSKAL_DEGREE %.1f\n", kruskalReal);
+    printf("#define MST_KRUSKAL_DEGREE_INTEGRAL %.1f\n", kruskalIntegral);
+    if(parallel == MST_PARALLEL_NEVER){
+        printf("#define MST_PARALLEL_MIN_EDGES MST_PARALLEL_NEVER\n");
+    }else{
+        printf("#define MST_PARALLEL_MIN_EDGES %lld\n", parallel);
+    }
+    return 0;
+}
@@ -0,0 +1,177 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+#include "cluster.h"
+#include "primmst.h"
+
+/* IMPLEMENTATION OF cluster.h */
+
+
+/* union-find root of v with path halving */
+static int findSet(int* set, int v){
+    while(set[v] != v){
+        set[v] = set[set[v]];
+        v = set[v];
+    }
+    return v;
+}
+
+
+/* see cluster.h */
+template <typename W>
+Dendrogram<W>::Dendrogram(const BasicGraph<W>* tree){
+    n = tree->numVerts();
+    int* targets = new int[n];
+    W* weights = new W[n];
+    std::vector<typename BasicGraph<W>::Edge> edges;
+    for(int v = 0; v < n; v++){
+        int degree = tree->successorEdges(v, targets, weights);
+        for(int index = 0; index < degree; index++){
+            if(targets[index] > v){
+                typename BasicGraph<W>::Edge e = {v, targets[index], weights[index]};
+                edges.push_back(e);
+            }
+        }
+    }
+    delete[] weights;
+    delete[] targets;
+    std::stable_sort(edges.begin(), edges.end(),
+                     [](const typename BasicGraph<W>::Edge& a,
+                        const typename BasicGraph<W>::Edge& b){ return a.weight < b.weight; });
+
+    //set is union-find over vertices; cluster[root] is its current cluster number
+    int* set = new int[n];
+    int* cluster = new int[n];
+    int* size = new int[n];
+    parent = new int[2 * n];
+    work = new int[3 * n];
+    for(int v = 0; v < n; v++){
+        set[v] = cluster[v] = v;
+        size[v] = 1;
+    }
+    for(int c = 0; c < 2 * n; c++){
+        parent[c] = -1;
+    }
+    for(int e = 0; e < (int)edges.size(); e++){
+        int a = findSet(set, edges[e].source);
+        int b = findSet(set, edges[e].target);
+        if(a == b){
+            continue;  //not a forest; ignore the edge closing a cycle
+        }
+        basicmerge<W> m;
+        m.left = std::min(cluster[a], cluster[b]);
+        m.right = std::max(cluster[a], cluster[b]);
+        m.height = edges[e].weight;
+        m.size = size[a] + size[b];
+        int made = n + (int)steps.size();
+        parent[m.left] = parent[m.right] = made;
+        steps.push_back(m);
+
+        set[a] = b;
+        size[b] = m.size;
+        cluster[b] = made;
+    }
+    delete[] size;
+    delete[] cluster;
+    delete[] set;
+}
+
+
+/* see cluster.h */
+template <typename W>
+Dendrogram<W>::~Dendrogram(){
+    delete[] parent;
+    delete[] work;
+}
+
+
+/* see cluster.h */
+template <typename W>
+int Dendrogram<W>::numVerts(){
+    return n;
+}
+
+
+/* see cluster.h */
+template <typename W>
+const vector<basicmerge<W> >& Dendrogram<W>::merges(){
+    return steps;
+}
+
+
+/* Label the clustering after the first made merges.  Parents have higher
+ numbers than their children, so going down from the top every cluster
+ either is a root (made, but its parent is not) or takes its parent's label.
+ The labels are then renumbered in order of lowest vertex. */
+template <typename W>
+int Dendrogram<W>::cut(int made, int* label){
+    int last = n + made;  //clusters below last exist
+    int roots = 0;
+    for(int c = n + (int)steps.size() - 1; c >= 0; c--){
+        if(c >= last){
+            work[c] = -1;
+        }else if(parent[c] == -1 || parent[c] >= last){
+            work[c] = roots++;
+        }else{
+            work[c] = work[parent[c]];
+        }
+    }
+    //renumber: rename[old] is the new label, -1 until first seen
+    int* rename = work + 2 * n;
+    int count = 0;
+    for(int r = 0; r < roots; r++){
+        rename[r] = -1;
+    }
+    for(int v = 0; v < n; v++){
+        if(rename[work[v]] == -1){
+            rename[work[v]] = count++;
+        }
+        label[v] = rename[work[v]];
+    }
+    return count;
+}
+
+
+/* see cluster.h */
+template <typename W>
+int Dendrogram<W>::cutK(int k, int* label){
+    int made = n - k;
+    if(made < 0){
+        made = 0;
+    }
+    if(made > (int)steps.size()){
+        made = (int)steps.size();
+    }
+    return cut(made, label);
+}
+
+
+/* see cluster.h */
+template <typename W>
+int Dendrogram<W>::cutThreshold(W threshold, int* label){
+    int made = std::upper_bound(steps.begin(), steps.end(), threshold,
+                                [](W t, const basicmerge<W>& m){ return t < m.height; })
+               - steps.begin();
+    return cut(made, label);
+}
+
+
+/* see cluster.h */
+template <typename W>
+unique_ptr<Dendrogram<W> > singleLinkage(const BasicGraph<W>* g){
+    unique_ptr<BasicGraph<W> > tree = minSpanTree(g);
+    return unique_ptr<Dendrogram<W> >(new Dendrogram<W>(tree.get()));
+}
+
+
+/* the weight types cluster is compiled for, same as BasicGraph in graph.cpp */
+#define CLUSTER_INSTANTIATE(W) \
+    template class Dendrogram<W>; \
+    template unique_ptr<Dendrogram<W> > singleLinkage<W>(const BasicGraph<W>*);
+
+CLUSTER_INSTANTIATE(float)
+CLUSTER_INSTANTIATE(double)
+CLUSTER_INSTANTIATE(uint16_t)
+CLUSTER_INSTANTIATE(uint32_t)
+CLUSTER_INSTANTIATE(int64_t)
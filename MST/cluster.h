@@ -0,0 +1,83 @@
+#ifndef CLUSTER_H
+#define CLUSTER_H
+
+#include "graph.h"
+#include <vector>
+
+/* Single-linkage clustering from a minimum spanning tree.
+ *
+ * The single-linkage clusters at distance d are the components of the
+ * graph's edges of weight <= d, which are the components of the MST's edges
+ * of weight <= d.  So merging the tree edges in increasing weight with
+ * union-find gives the whole hierarchy (the dendrogram) at once, and any
+ * clustering is a cut of it.
+ *
+ * Clusters are numbered as in the usual linkage matrix: the vertices are
+ * clusters 0 .. n-1, and merge i makes cluster n+i.
+ */
+
+
+/* Merge of clusters left and right (left < right) at distance height,
+ * giving a cluster of size vertices.
+ */
+template <typename W>
+struct basicmerge {
+    int left;
+    int right;
+    W height;
+    int size;
+};
+typedef basicmerge<float> Merge;
+
+
+template <typename W>
+class Dendrogram {
+
+ public:
+
+  /* Build the dendrogram of a minimum spanning tree (or forest), such as
+   * minSpanTree returns.  Sorts the n-1 tree edges, so O(V log V).
+   */
+  Dendrogram(const BasicGraph<W>* tree);
+  ~Dendrogram();
+
+  int numVerts();
+
+  /* The merges, in increasing height (ties in vertex order).  There are
+   * n-1 of them, fewer if the tree is a forest: the components never merge.
+   */
+  const vector<basicmerge<W> >& merges();
+
+  /* Put in label[v] (label is numVerts() long) the cluster of each vertex,
+   * numbered 0, 1, ... in order of their lowest vertex, for the clustering
+   * with k clusters, i.e. after the first n-k merges.  Returns the number of
+   * clusters, which is k unless k is less than 1 or the number of components
+   * (then it is the number of components) or more than n (then n).  O(V).
+   */
+  int cutK(int k, int* label);
+
+  /* Same, for the clustering in which every merge of height <= threshold
+   * has been made.  O(V).
+   */
+  int cutThreshold(W threshold, int* label);
+
+ private:
+  Dendrogram(const Dendrogram&) = delete;
+  Dendrogram& operator=(const Dendrogram&) = delete;
+
+  int cut(int made, int* label);  //label after the first made merges
+
+  int n;                        //number of vertices
+  vector<basicmerge<W> > steps; //the merges
+  int* parent;                  //parent[c] is the cluster c merged into, or -1
+  int* work;                    //cluster labels, then new labels, during a cut
+};
+
+
+/* The dendrogram of g (symmetric, as for minSpanTree), computing its
+ * minimum spanning tree first.  Keep the result to cut it many times.
+ */
+template <typename W>
+unique_ptr<Dendrogram<W> > singleLinkage(const BasicGraph<W>* g);
+
+#endif
@@ -0,0 +1,390 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include "compressed.h"
+
+/* IMPLEMENTATION OF compressed.h */
+
+/* A vertex is stored as
+     varint degree
+     degree weights, each 1 (8 bit), 2 (16 bit) or sizeof(W) bytes
+     varint first target, varint differences to the next targets
+   The weights come first because they have a fixed size, so edge() finds
+   the k-th weight without decoding the rest of the targets. */
+
+
+/* bytes of the varint of x */
+static int varintSize(unsigned int x){
+    int size = 1;
+    while(x >= 0x80){
+        x >>= 7;
+        size++;
+    }
+    return size;
+}
+
+/* write x as a varint at p, returning the position after it */
+static unsigned char* putVarint(unsigned char* p, unsigned int x){
+    while(x >= 0x80){
+        *p++ = (unsigned char)(x | 0x80);
+        x >>= 7;
+    }
+    *p++ = (unsigned char)x;
+    return p;
+}
+
+/* read a varint at p into *x, returning the position after it.
+ Most values fit one byte, so that case goes first. */
+static inline const unsigned char* getVarint(const unsigned char* p, unsigned int* x){
+    if(*p < 0x80){
+        *x = *p;
+        return p + 1;
+    }
+    unsigned int value = 0;
+    int shift = 0;
+    while(*p >= 0x80){
+        value |= (unsigned int)(*p++ & 0x7f) << shift;
+        shift += 7;
+    }
+    *x = value | ((unsigned int)*p << shift);
+    return p + 1;
+}
+
+
+/* see compressed.h */
+template <typename W>
+CompressedGraph<W>::CompressedGraph(const BasicGraph<W>* g, int weightBits){
+    numVertices = g->numVerts();
+    int* start = new int[numVertices + 1];
+    start[0] = 0;
+    for(int v = 0; v < numVertices; v++){
+        start[v + 1] = start[v] + g->outDegree(v);
+    }
+    int* targets = new int[start[numVertices]];
+    W* weights = new W[start[numVertices]];
+    for(int v = 0; v < numVertices; v++){
+        g->successorEdges(v, targets + start[v], weights + start[v]);
+    }
+    build(start, targets, weights, weightBits);
+    delete[] weights;
+    delete[] targets;
+    delete[] start;
+}
+
+
+/* see compressed.h */
+template <typename W>
+CompressedGraph<W>::CompressedGraph(int n, const Edge* batch, int count, bool symmetric,
+                                    int weightBits){
+    numVertices = (n < 1) ? 1 : n;
+    //the same edges addEdge would accept, bucketed by source in batch order
+    int* start = new int[numVertices + 1];
+    for(int v = 0; v <= numVertices; v++){
+        start[v] = 0;
+    }
+    int copies = symmetric ? 2 : 1;
+    for(int i = 0; i < count; i++){
+        const Edge& e = batch[i];
+        if(e.source < 0 || e.source >= numVertices || e.target < 0 || e.target >= numVertices
+           || e.weight == WeightTraits<W>::noEdge() || e.weight < 0){
+            continue;
+        }
+        start[e.source + 1]++;
+        if(symmetric){
+            start[e.target + 1]++;
+        }
+    }
+    for(int v = 0; v < numVertices; v++){
+        start[v + 1] += start[v];
+    }
+    int* fill = new int[numVertices];
+    for(int v = 0; v < numVertices; v++){
+        fill[v] = start[v];
+    }
+    int* targets = new int[start[numVertices]];
+    W* weights = new W[start[numVertices]];
+    for(int i = 0; i < count; i++){
+        const Edge& e = batch[i];
+        if(e.source < 0 || e.source >= numVertices || e.target < 0 || e.target >= numVertices
+           || e.weight == WeightTraits<W>::noEdge() || e.weight < 0){
+            continue;
+        }
+        for(int c = 0; c < copies; c++){
+            int s = (c == 0) ? e.source : e.target;
+            int t = (c == 0) ? e.target : e.source;
+            targets[fill[s]] = t;
+            weights[fill[s]] = e.weight;
+            fill[s]++;
+        }
+    }
+    delete[] fill;
+    build(start, targets, weights, weightBits);
+    delete[] weights;
+    delete[] targets;
+    delete[] start;
+}
+
+
+/* see compressed.h */
+template <typename W>
+CompressedGraph<W>::CompressedGraph(int n, const int* start, int* targets, W* weights,
+                                    int weightBits){
+    numVertices = n;
+    build(start, targets, weights, weightBits);
+}
+
+
+/* Encode the adjacency in targets/weights[start[v] .. start[v+1]-1] for
+ each v.  Each range is sorted by target, keeping the first of equal
+ targets as addEdge would, so the arrays are reordered in place. */
+template <typename W>
+void CompressedGraph<W>::build(const int* start, int* targets, W* weights, int weightBits){
+    int* degree = new int[numVertices];
+    int* order = new int[numVertices];  //room for one vertex's permutation, grown as needed
+    int orderSize = numVertices;
+    int* sortedT = new int[numVertices];
+    W* sortedW = new W[numVertices];
+    edges = 0;
+    for(int v = 0; v < numVertices; v++){
+        int from = start[v], size = start[v + 1] - start[v];
+        if(size > orderSize){
+            delete[] order; delete[] sortedT; delete[] sortedW;
+            orderSize = size;
+            order = new int[size]; sortedT = new int[size]; sortedW = new W[size];
+        }
+        for(int i = 0; i < size; i++){
+            order[i] = i;
+        }
+        std::stable_sort(order, order + size,
+                         [targets, from](int a, int b){ return targets[from + a] < targets[from + b]; });
+        int kept = 0;
+        for(int i = 0; i < size; i++){
+            int t = targets[from + order[i]];
+            if(kept > 0 && sortedT[kept - 1] == t){
+                continue;
+            }
+            sortedT[kept] = t;
+            sortedW[kept] = weights[from + order[i]];
+            kept++;
+        }
+        memcpy(targets + from, sortedT, kept * sizeof(int));
+        memcpy(weights + from, sortedW, kept * sizeof(W));
+        degree[v] = kept;
+        edges += kept;
+    }
+    delete[] order; delete[] sortedT; delete[] sortedW;
+
+    bits = (weightBits == 8 || weightBits == 16) ? weightBits : 0;
+    low = step = 0;
+    if(bits != 0){
+        double high = 0;
+        bool any = false;
+        for(int v = 0; v < numVertices; v++){
+            for(int i = start[v]; i < start[v] + degree[v]; i++){
+                double w = (double)weights[i];
+                if(!any || w < low) low = w;
+                if(!any || w > high) high = w;
+                any = true;
+            }
+        }
+        double levels = (double)((1 << bits) - 1);
+        step = (high - low) / levels;
+        if(numeric_limits<W>::is_integer && high - low <= levels){
+            step = 1;
+        }
+    }
+    int weightSize = (bits == 0) ? (int)sizeof(W) : bits / 8;
+
+    offset = new size_t[numVertices + 1];
+    offset[0] = 0;
+    for(int v = 0; v < numVertices; v++){
+        size_t size = varintSize(degree[v]) + (size_t)degree[v] * weightSize;
+        for(int i = 0; i < degree[v]; i++){
+            int t = targets[start[v] + i];
+            size += varintSize((i == 0) ? t : t - targets[start[v] + i - 1]);
+        }
+        offset[v + 1] = offset[v] + size;
+    }
+    data = new unsigned char[offset[numVertices] + 1];
+
+    for(int v = 0; v < numVertices; v++){
+        unsigned char* p = putVarint(data + offset[v], degree[v]);
+        for(int i = 0; i < degree[v]; i++){
+            W w = weights[start[v] + i];
+            if(bits == 0){
+                memcpy(p, &w, sizeof(W));
+            }else{
+                double q = (step == 0) ? 0 : floor(((double)w - low) / step + 0.5);
+                unsigned int level = (unsigned int)std::min(q, (double)((1 << bits) - 1));
+                if(bits == 8){
+                    p[0] = (unsigned char)level;
+                }else{
+                    uint16_t half = (uint16_t)level;
+                    memcpy(p, &half, 2);
+                }
+            }
+            p += weightSize;
+        }
+        for(int i = 0; i < degree[v]; i++){
+            int t = targets[start[v] + i];
+            p = putVarint(p, (i == 0) ? t : t - targets[start[v] + i - 1]);
+        }
+    }
+    delete[] degree;
+}
+
+
+/* see compressed.h */
+template <typename W>
+CompressedGraph<W>::~CompressedGraph(){
+    delete[] offset;
+    delete[] data;
+}
+
+
+/* the weight stored at p */
+template <typename W>
+W CompressedGraph<W>::decodeWeight(const unsigned char* p) const{
+    if(bits == 0){
+        W w;
+        memcpy(&w, p, sizeof(W));
+        return w;
+    }
+    unsigned int level;
+    if(bits == 8){
+        level = p[0];
+    }else{
+        uint16_t half;
+        memcpy(&half, p, 2);
+        level = half;
+    }
+    double w = low + level * step;
+    return numeric_limits<W>::is_integer ? (W)floor(w + 0.5) : (W)w;
+}
+
+
+/* see compressed.h */
+template <typename W>
+int CompressedGraph<W>::numVerts() const{
+    return numVertices;
+}
+
+
+/* see compressed.h */
+template <typename W>
+int CompressedGraph<W>::representation() const{
+    return COMPRESSED;
+}
+
+
+/* see compressed.h */
+template <typename W>
+long long CompressedGraph<W>::numEdges() const{
+    return edges;
+}
+
+
+/* see compressed.h */
+template <typename W>
+size_t CompressedGraph<W>::memoryFootprint() const{
+    return sizeof(*this) + (numVertices + 1) * sizeof(size_t) + offset[numVertices] + 1;
+}
+
+
+/* see compressed.h */
+template <typename W>
+W CompressedGraph<W>::edge(int source, int target) const{
+    if(source >= numVertices || source < 0 || target >= numVertices || target < 0){
+        return WeightTraits<W>::badVertex();
+    }
+    unsigned int degree;
+    const unsigned char* w = getVarint(data + offset[source], &degree);
+    int weightSize = (bits == 0) ? (int)sizeof(W) : bits / 8;
+    const unsigned char* p = w + (size_t)degree * weightSize;
+    int t = 0;
+    for(unsigned int i = 0; i < degree; i++){
+        unsigned int x;
+        p = getVarint(p, &x);
+        t += x;
+        if(t == target){
+            return decodeWeight(w + (size_t)i * weightSize);
+        }
+        if(t > target){
+            break;
+        }
+    }
+    return WeightTraits<W>::noEdge();
+}
+
+
+/* see compressed.h */
+template <typename W>
+int CompressedGraph<W>::successorEdges(int source, int* targets, W* weights) const{
+    if(source >= numVertices || source < 0){
+        return -1;
+    }
+    unsigned int degree;
+    const unsigned char* p = getVarint(data + offset[source], &degree);
+    if(bits == 0){
+        memcpy(weights, p, (size_t)degree * sizeof(W));
+        p += (size_t)degree * sizeof(W);
+    }else{
+        int weightSize = bits / 8;
+        for(unsigned int i = 0; i < degree; i++){
+            weights[i] = decodeWeight(p);
+            p += weightSize;
+        }
+    }
+    int t = 0;
+    for(unsigned int i = 0; i < degree; i++){
+        unsigned int x;
+        p = getVarint(p, &x);
+        t += x;
+        targets[i] = t;
+    }
+    return degree;
+}
+
+
+/* see compressed.h */
+template <typename W>
+int CompressedGraph<W>::outDegree(int source) const{
+    if(source >= numVertices || source < 0){
+        return -1;
+    }
+    unsigned int degree;
+    getVarint(data + offset[source], &degree);
+    return degree;
+}
+
+
+/* see compressed.h */
+template <typename W>
+unique_ptr<int[]> CompressedGraph<W>::successors(int source) const{
+    if(source >= numVertices || source < 0){
+        return NULL;
+    }
+    unsigned int degree;
+    const unsigned char* p = getVarint(data + offset[source], &degree);
+    p += (size_t)degree * ((bits == 0) ? (int)sizeof(W) : bits / 8);
+    int* s = new int[degree + 1];
+    int t = 0;
+    for(unsigned int i = 0; i < degree; i++){
+        unsigned int x;
+        p = getVarint(p, &x);
+        t += x;
+        s[i] = t;
+    }
+    s[degree] = -1;
+    return unique_ptr<int[]>(s);
+}
+
+
+/* the weight types CompressedGraph is compiled for, same as BasicGraph in graph.cpp */
+template class CompressedGraph<float>;
+template class CompressedGraph<double>;
+template class CompressedGraph<uint16_t>;
+template class CompressedGraph<uint32_t>;
+template class CompressedGraph<int64_t>;
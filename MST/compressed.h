@@ -0,0 +1,87 @@
+#ifndef COMPRESSED_H
+#define COMPRESSED_H
+
+#include "graph.h"
+
+/* A read-only graph in compressed adjacency form, for graphs too big to
+ * hold as a LIST (about 16 bytes of Node per edge, plus the arena).
+ *
+ * The successors of each vertex are sorted and stored as the first one
+ * followed by the differences between neighbors, each as a varint (7 bits
+ * per byte, high bit set on all but the last byte), so a target costs one
+ * byte when the vertex numbers of neighbors are close, which reorder.h can
+ * arrange.  The weights of a vertex come before its targets, after its
+ * degree, either exactly (sizeof(W) bytes each) or quantized to 8 or 16
+ * bits between the smallest and largest weight of the graph.  One byte
+ * array holds all vertices, with the starting position of each.
+ *
+ * A CompressedGraph has the read interface of the graph concept (see
+ * graphrep.h), so minSpanTree and PrimSolver run on it directly; a vertex is
+ * decoded in one go by successorEdges.  Successors come in increasing order.
+ * There is no addEdge or delEdge: build a new one instead.
+ */
+
+#define COMPRESSED 4   /* representation() of a CompressedGraph; BasicGraph does not take it */
+
+template <typename W>
+class CompressedGraph {
+
+ public:
+  typedef W weight_type;
+  typedef typename BasicGraph<W>::Edge Edge;
+
+  /* Compress g.  weightBits is 8 or 16 to quantize the weights to that many
+   * bits (then edge() and successorEdges give the nearest of 2^weightBits
+   * evenly spaced values between the smallest and largest weight, exact if
+   * W is an integer type and the weights span fewer values), or anything
+   * else to keep them exact.
+   */
+  CompressedGraph(const BasicGraph<W>* g, int weightBits);
+
+  /* Build from a batch of edges without making a BasicGraph first, with
+   * the same edges addEdges(batch, count, symmetric) would put in an empty
+   * BasicGraph(n, LIST).  If n < 1 it is raised to 1, as for BasicGraph.
+   */
+  CompressedGraph(int n, const Edge* batch, int count, bool symmetric, int weightBits);
+
+  /* Build from adjacency arrays: the edges out of v are to targets[i] with
+   * weight weights[i] for start[v] <= i < start[v+1], all valid (as addEdge
+   * checks); of several to the same target the first wins.  targets and
+   * weights are reordered in place, and can be freed afterwards.
+   */
+  CompressedGraph(int n, const int* start, int* targets, W* weights, int weightBits);
+
+  ~CompressedGraph();
+
+  int numVerts() const;
+  int representation() const;
+
+  /* number of edges (each direction of a symmetric graph counts) */
+  long long numEdges() const;
+
+  /* bytes of memory held by the graph, as BasicGraph::memoryFootprint */
+  size_t memoryFootprint() const;
+
+  /* as in graph.h */
+  W edge(int source, int target) const;
+  int successorEdges(int source, int* targets, W* weights) const;
+  int outDegree(int source) const;
+  unique_ptr<int[]> successors(int source) const;
+
+ private:
+  CompressedGraph(const CompressedGraph&) = delete;
+  CompressedGraph& operator=(const CompressedGraph&) = delete;
+
+  void build(const int* start, int* targets, W* weights, int weightBits);
+  W decodeWeight(const unsigned char* p) const;
+
+  int numVertices;
+  long long edges;      //number of edges
+  int bits;             //8 or 16 for quantized weights, 0 for exact
+  double low;           //quantized weight q stands for low + q*step
+  double step;
+  size_t* offset;       //vertex v is data[offset[v] .. offset[v+1]-1]
+  unsigned char* data;  //for each vertex: degree, weights, then targets
+};
+
+#endif
@@ -0,0 +1,309 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
+#include "dispatch.h"
+#include "graphrep.h"
+#include "primmst.h"
+#include "parallelprim.h"
+
+/* IMPLEMENTATION OF dispatch.h */
+
+
+/* see dispatch.h */
+MSTThresholds defaultThresholds(){
+    MSTThresholds limits;
+    limits.denseFraction = MST_DENSE_FRACTION;
+    limits.kruskalDegree = MST_KRUSKAL_DEGREE;
+    limits.kruskalDegreeIntegral = MST_KRUSKAL_DEGREE_INTEGRAL;
+    limits.parallelMinEdges = MST_PARALLEL_MIN_EDGES;
+    return limits;
+}
+
+
+/* see dispatch.h */
+const char* engineName(int engine){
+    switch(engine){
+    case MST_PRIM_HEAP:
+        return "prim-heap";
+    case MST_PRIM_BUCKET:
+        return "prim-bucket";
+    case MST_PRIM_DENSE:
+        return "prim-dense";
+    case MST_KRUSKAL:
+        return "kruskal";
+    case MST_PARALLEL:
+        return "parallel-prim";
+    }
+    return "unknown";
+}
+
+
+/* Prim's without a queue: the next vertex is found by scanning the
+ distances of the vertices not in the tree yet.  Those are kept packed at
+ the front of left[], with their distances in key[] at the same position,
+ so each scan is one pass over a shrinking array.  When none of them is
+ reachable, one of them starts a new tree.
+ With byEdge (for the matrices) the edges from v are read with edge() in the
+ same pass that looks for the next vertex, rather than with successorEdges. */
+template <class G>
+static unique_ptr<BasicGraph<typename G::weight_type> > densePrim(const G& g, bool byEdge){
+    typedef typename G::weight_type W;
+    int n = g.numVerts();
+    int* link = new int[n];
+    int* left = new int[n];
+    W* key = new W[n];
+    int* at = new int[n];       //position of each vertex in left, -1 once in the tree
+    int* targets = new int[n];
+    W* weights = new W[n];
+    for(int v = 0; v < n; v++){
+        link[v] = -1;
+        left[v] = v;
+        key[v] = WeightTraits<W>::noEdge();
+        at[v] = v;
+    }
+
+    std::vector<typename BasicGraph<W>::Edge> edges;
+    edges.reserve(n);
+    int best = 0;
+    for(int remaining = n - 1; remaining >= 0; remaining--){
+        //take out left[best], moving the last one into its place
+        int v = left[best];
+        if(link[v] != -1){
+            typename BasicGraph<W>::Edge e = {link[v], v, key[best]};
+            edges.push_back(e);
+        }
+        left[best] = left[remaining];
+        key[best] = key[remaining];
+        at[left[best]] = best;
+        at[v] = -1;
+
+        best = 0;
+        if(byEdge){
+            for(int i = 0; i < remaining; i++){
+                W w = g.edge(v, left[i]);
+                if(w < key[i]){
+                    key[i] = w;
+                    link[left[i]] = v;
+                }
+                if(key[i] < key[best]){
+                    best = i;
+                }
+            }
+        }else{
+            int degree = g.successorEdges(v, targets, weights);
+            for(int index = 0; index < degree; index++){
+                int i = at[targets[index]];
+                if(i != -1 && weights[index] < key[i]){
+                    key[i] = weights[index];
+                    link[targets[index]] = v;
+                }
+            }
+            for(int i = 1; i < remaining; i++){
+                if(key[i] < key[best]){
+                    best = i;
+                }
+            }
+        }
+    }
+
+    unique_ptr<BasicGraph<W> > MST(new BasicGraph<W>(n, ULIST));
+    MST->addEdges(edges.data(), (int)edges.size(), false);
+    delete[] weights;
+    delete[] targets;
+    delete[] at;
+    delete[] key;
+    delete[] left;
+    delete[] link;
+    return MST;
+}
+
+
+/* union-find root of v with path halving */
+static int findSet(int* set, int v){
+    while(set[v] != v){
+        set[v] = set[set[v]];
+        v = set[v];
+    }
+    return v;
+}
+
+
+/* Kruskal's: the edges (each once, lower end first) in increasing weight,
+ kept when they join two different trees. */
+template <typename W>
+static unique_ptr<BasicGraph<W> > kruskal(const BasicGraph<W>* g){
+    int n = g->numVerts();
+    int* targets = new int[n];
+    W* weights = new W[n];
+    std::vector<typename BasicGraph<W>::Edge> edges;
+    for(int v = 0; v < n; v++){
+        int degree = g->successorEdges(v, targets, weights);
+        for(int index = 0; index < degree; index++){
+            if(targets[index] > v){
+                typename BasicGraph<W>::Edge e = {v, targets[index], weights[index]};
+                edges.push_back(e);
+            }
+        }
+    }
+    delete[] weights;
+    delete[] targets;
+    std::sort(edges.begin(), edges.end(),
+              [](const typename BasicGraph<W>::Edge& a,
+                 const typename BasicGraph<W>::Edge& b){ return a.weight < b.weight; });
+
+    int* set = new int[n];
+    int* size = new int[n];
+    for(int v = 0; v < n; v++){
+        set[v] = v;
+        size[v] = 1;
+    }
+    int kept = 0;
+    for(int e = 0; e < (int)edges.size() && kept < n - 1; e++){
+        int a = findSet(set, edges[e].source);
+        int b = findSet(set, edges[e].target);
+        if(a == b){
+            continue;
+        }
+        if(size[a] < size[b]){
+            std::swap(a, b);
+        }
+        set[b] = a;
+        size[a] += size[b];
+        edges[kept++] = edges[e];
+    }
+    delete[] size;
+    delete[] set;
+
+    unique_ptr<BasicGraph<W> > MST(new BasicGraph<W>(n, ULIST));
+    MST->addEdges(edges.data(), kept, false);
+    return MST;
+}
+
+
+/* chooseEngine, also setting *maxWeight to the largest weight when it
+ looked at the weights and they were integral, and to -1 otherwise.  The
+ weights are only looked at when they decide between the engines left
+ after the dense and the parallel ones. */
+template <typename W>
+static int choose(const BasicGraph<W>* g, const MSTThresholds& limits, MSTReport* report,
+                  int* maxWeight){
+    int n = g->numVerts();
+    long long m = 0;
+    for(int v = 0; v < n; v++){
+        m += g->outDegree(v);
+    }
+    double degree = (double)m / n;
+    int threads = (int)std::thread::hardware_concurrency();
+    if(threads < 1){
+        threads = 1;
+    }
+
+    int rep = g->representation();
+    bool integral = false;
+    *maxWeight = -1;
+    int engine;
+    if((rep == MATRIX || rep == UMATRIX) && n > 1 && m >= limits.denseFraction * n * (double)(n - 1)){
+        engine = MST_PRIM_DENSE;
+    }else if(threads > 1 && m >= limits.parallelMinEdges){
+        engine = MST_PARALLEL;
+    }else if(degree <= limits.kruskalDegree && degree <= limits.kruskalDegreeIntegral){
+        engine = MST_KRUSKAL;  //whatever the weights
+    }else{
+        integral = integralWeights(g, maxWeight);
+        if(integral){
+            engine = (degree <= limits.kruskalDegreeIntegral) ? MST_KRUSKAL : MST_PRIM_BUCKET;
+        }else{
+            engine = (degree <= limits.kruskalDegree) ? MST_KRUSKAL : MST_PRIM_HEAP;
+            *maxWeight = -1;
+        }
+    }
+
+    if(report != NULL){
+        report->engine = engine;
+        report->vertices = n;
+        report->edges = m;
+        report->representation = rep;
+        report->integral = integral;
+        report->threads = threads;
+    }
+    return engine;
+}
+
+
+/* see dispatch.h */
+template <typename W>
+int chooseEngine(const BasicGraph<W>* g, const MSTThresholds& limits, MSTReport* report){
+    int maxWeight;
+    return choose(g, limits, report, &maxWeight);
+}
+
+
+/* runEngine, with maxWeight from choose for the bucket queue (-1 if the
+ weights were not looked at) */
+template <typename W>
+static unique_ptr<BasicGraph<W> > run(const BasicGraph<W>* g, int engine, int maxWeight){
+    switch(engine){
+    case MST_PRIM_HEAP:
+    case MST_PRIM_BUCKET: {
+        PrimSolver<W> solver;
+        solver.allowBuckets(engine == MST_PRIM_BUCKET);
+        if(maxWeight >= 0){
+            solver.knownWeights(maxWeight);
+        }
+        solver.solve(*g);
+        return solver.tree();
+    }
+    case MST_PRIM_DENSE:
+        if(g->representation() == MATRIX){
+            return densePrim(RepView<MatrixRep, W>(*g), true);
+        }else if(g->representation() == UMATRIX){
+            return densePrim(RepView<UMatrixRep, W>(*g), true);
+        }
+        return densePrim(*g, false);
+    case MST_KRUSKAL:
+        return kruskal(g);
+    case MST_PARALLEL:
+        return parallelPrim(g, 0);
+    }
+    return NULL;
+}
+
+
+/* see dispatch.h */
+template <typename W>
+unique_ptr<BasicGraph<W> > runEngine(const BasicGraph<W>* g, int engine){
+    return run(g, engine, -1);
+}
+
+
+/* see dispatch.h */
+template <typename W>
+unique_ptr<BasicGraph<W> > computeMST(const BasicGraph<W>* g, const MSTThresholds& limits,
+                                      MSTReport* report){
+    int maxWeight;
+    int engine = choose(g, limits, report, &maxWeight);
+    return run(g, engine, maxWeight);
+}
+
+
+/* see dispatch.h */
+template <typename W>
+unique_ptr<BasicGraph<W> > computeMST(const BasicGraph<W>* g, MSTReport* report){
+    return computeMST(g, defaultThresholds(), report);
+}
+
+
+/* the weight types dispatch is compiled for, same as BasicGraph in graph.cpp */
+#define DISPATCH_INSTANTIATE(W) \
+    template int chooseEngine<W>(const BasicGraph<W>*, const MSTThresholds&, MSTReport*); \
+    template unique_ptr<BasicGraph<W> > runEngine<W>(const BasicGraph<W>*, int); \
+    template unique_ptr<BasicGraph<W> > computeMST<W>(const BasicGraph<W>*, const MSTThresholds&, MSTReport*); \
+    template unique_ptr<BasicGraph<W> > computeMST<W>(const BasicGraph<W>*, MSTReport*);
+
+DISPATCH_INSTANTIATE(float)
+DISPATCH_INSTANTIATE(double)
+DISPATCH_INSTANTIATE(uint16_t)
+DISPATCH_INSTANTIATE(uint32_t)
+DISPATCH_INSTANTIATE(int64_t)
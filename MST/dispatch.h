@@ -0,0 +1,121 @@
+#ifndef DISPATCH_H
+#define DISPATCH_H
+
+#include "graph.h"
+
+/* One entry point for the minimum spanning tree that picks the algorithm
+ * (the engine) from the shape of the graph.
+ *
+ * Which engine is fastest depends on the graph:
+ *  - Prim's on the MinPrio heap, O(E log V), for the general case.
+ *  - Prim's on the bucket queue, about O(E + V + maxWeight), when the
+ *    weights are small whole numbers (see integralWeights in primmst.h).
+ *  - Prim's without a queue, scanning all distances for the next vertex,
+ *    O(V^2) but with nothing but array reads; on a MATRIX or UMATRIX it
+ *    reads the row of the new vertex in the same pass, so it wins on dense
+ *    matrices, where E is close to V^2 anyway.
+ *  - Kruskal's, sorting the edges and joining them with union-find,
+ *    O(E log E); it wins on sparse graphs, where Prim's spends its
+ *    time on the queue.
+ *  - Prim's from many roots on all hardware threads, then Boruvka's (see
+ *    parallelprim.h), for big graphs on a machine with several cores.
+ *
+ * computeMST looks at V, E, the representation and whether the weights are
+ * integral, and the number of hardware threads, and compares them with
+ * thresholds measured by calibrate.cpp (build it as the comment there says
+ * and paste what it prints over the MST_* defines below).  Every engine
+ * returns a minimum spanning tree (a forest for a disconnected graph) as a
+ * ULIST graph, with the same assumptions as minSpanTree; on equal weights
+ * they may pick different trees.
+ */
+
+#define MST_PRIM_HEAP 0
+#define MST_PRIM_BUCKET 1
+#define MST_PRIM_DENSE 2
+#define MST_KRUSKAL 3
+#define MST_PARALLEL 4
+#define MST_ENGINES 5   /* number of engines */
+
+/* Defaults of MSTThresholds.  The first three are from calibrate on the
+ * development machine.  That machine has one core, so there is no measured
+ * threshold for parallel Prim's, and by default computeMST never picks it:
+ * MST_PARALLEL is opt-in, through runEngine(g, MST_PARALLEL) or an
+ * MSTThresholds with a parallelMinEdges from calibrate on the target
+ * machine. */
+#define MST_DENSE_FRACTION 0.3
+#define MST_KRUSKAL_DEGREE 24.0
+#define MST_KRUSKAL_DEGREE_INTEGRAL 16.0
+#define MST_PARALLEL_MIN_EDGES MST_PARALLEL_NEVER
+
+#define MST_PARALLEL_NEVER (1LL << 40)  /* a parallelMinEdges no graph reaches */
+
+
+/* When computeMST picks which engine:
+ *   MATRIX or UMATRIX, and
+ *   E >= denseFraction * V*(V-1)           Prim's without a queue
+ *   more than one hardware thread, and
+ *   E >= parallelMinEdges                  parallel Prim's (never by default)
+ *   otherwise, with integral weights:
+ *     E/V <= kruskalDegreeIntegral         Kruskal's
+ *     else                                 Prim's on buckets
+ *   otherwise:
+ *     E/V <= kruskalDegree                 Kruskal's
+ *     else                                 Prim's on the heap
+ * E counts both directions of each undirected edge, as outDegree does.
+ */
+struct MSTThresholds {
+    double denseFraction;
+    double kruskalDegree;
+    double kruskalDegreeIntegral;
+    long long parallelMinEdges;
+};
+
+/* the thresholds from the MST_* defines */
+MSTThresholds defaultThresholds();
+
+
+/* What computeMST looked at and what it picked. */
+struct MSTReport {
+    int engine;          //MST_PRIM_HEAP, ...
+    int vertices;        //V
+    long long edges;     //E, as above
+    int representation;  //of the input graph
+    bool integral;       //integralWeights held (false if the engine did not depend on it)
+    int threads;         //hardware threads available
+};
+
+/* the name of an engine, such as "prim-heap", or "unknown" */
+const char* engineName(int engine);
+
+
+/* The minimum spanning tree of g, by the engine the default thresholds
+ * pick.  If report is not NULL, it is filled in.
+ */
+template <typename W>
+unique_ptr<BasicGraph<W> > computeMST(const BasicGraph<W>* g, MSTReport* report);
+
+/* Same, with the given thresholds. */
+template <typename W>
+unique_ptr<BasicGraph<W> > computeMST(const BasicGraph<W>* g, const MSTThresholds& limits,
+                                      MSTReport* report);
+
+/* Which engine computeMST would use, without running it; report as above.
+ * Counts the edges with outDegree, and looks at the weights (O(V + E))
+ * only when they decide the engine: not for the dense or the parallel
+ * engine, nor when E/V is small enough for Kruskal's either way.
+ * computeMST hands what it found to Prim's on buckets, which then does not
+ * look again.
+ */
+template <typename W>
+int chooseEngine(const BasicGraph<W>* g, const MSTThresholds& limits, MSTReport* report);
+
+/* The minimum spanning tree of g by the given engine, whatever the shape
+ * of g (for calibrate and for testing).  MST_PRIM_BUCKET falls back to the
+ * heap when the weights are not integral, and MST_PARALLEL runs on all
+ * hardware threads; this is the way to use MST_PARALLEL with the default
+ * thresholds.  Returns NULL for an unknown engine.
+ */
+template <typename W>
+unique_ptr<BasicGraph<W> > runEngine(const BasicGraph<W>* g, int engine);
+
+#endif
@@ -0,0 +1,102 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "graph.h"
+#include "distmst.h"
+
+/*
+ * Time and traffic of distributedMST (see distmst.h) for 1, 2, 4, ... 16
+ * worker processes (or the number given), on one random connected graph
+ * (a random path through all vertices plus random edges, average degree
+ * DEGREE, weights uniform in [1, 1000]).
+ *
+ * For each number of workers prints the total time and the weight of the
+ * tree (the same for every number of workers), then one line per round:
+ * its time, the candidates sent up and how many of them cross partitions,
+ * and the bytes up to the coordinator and down to the workers.
+ *
+ * Build and run with
+ *
+ *   g++ -O2 distbench.cpp graph.cpp distmst.cpp -pthread -o distbench
+ *   ./distbench [maxworkers [vertices]]
+ */
+
+#define DEGREE 8.0   /* average out degree of the graph (both directions count) */
+
+
+/* n vertices in a ULIST graph, connected, about DEGREE*n/2 edges */
+static unique_ptr<BasicGraph<float> > randomGraph(int n, unsigned seed){
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    std::uniform_real_distribution<double> weight(1, 1000);
+    std::vector<int> order(n);
+    for(int v = 0; v < n; v++){
+        order[v] = v;
+    }
+    std::shuffle(order.begin(), order.end(), random);
+
+    std::vector<BasicGraph<float>::Edge> edges;
+    long long wanted = (long long)(DEGREE * n / 2);
+    for(int i = 0; i + 1 < n; i++){
+        BasicGraph<float>::Edge e = {order[i], order[i + 1], (float)weight(random)};
+        edges.push_back(e);
+    }
+    while((long long)edges.size() < wanted){
+        BasicGraph<float>::Edge e = {vertex(random), vertex(random), (float)weight(random)};
+        if(e.source != e.target){
+            edges.push_back(e);
+        }
+    }
+    unique_ptr<BasicGraph<float> > g(new BasicGraph<float>(n, ULIST));
+    g->addEdges(edges.data(), (int)edges.size(), false);
+    return g;
+}
+
+
+/* sum of the weights of an undirected tree, each edge once */
+static double treeWeight(const BasicGraph<float>* tree){
+    int n = tree->numVerts();
+    std::vector<int> targets(n);
+    std::vector<float> weights(n);
+    double total = 0;
+    for(int v = 0; v < n; v++){
+        int degree = tree->successorEdges(v, targets.data(), weights.data());
+        for(int i = 0; i < degree; i++){
+            if(v <= targets[i]){
+                total += weights[i];
+            }
+        }
+    }
+    return total;
+}
+
+
+int main(int argc, char** argv){
+    int maxWorkers = (argc > 1) ? atoi(argv[1]) : 16;
+    int n = (argc > 2) ? atoi(argv[2]) : 200000;
+    unique_ptr<BasicGraph<float> > g = randomGraph(n, 1);
+    printf("%d vertices, average degree %.0f\n", n, DEGREE);
+
+    for(int workers = 1; workers <= maxWorkers; workers *= 2){
+        DistStats stats;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        unique_ptr<BasicGraph<float> > tree = distributedMST(g.get(), workers, &stats);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if(tree == NULL){
+            printf("\n%d workers: failed\n", workers);
+            continue;
+        }
+        printf("\n%d workers: %.3f s, tree weight %.0f\n", workers, seconds, treeWeight(tree.get()));
+        printf("%8s %10s %12s %12s %14s %14s\n", "round", "seconds", "candidates", "cross",
+               "bytes up", "bytes down");
+        for(size_t r = 0; r < stats.rounds.size(); r++){
+            const DistRound& round = stats.rounds[r];
+            printf("%8d %10.4f %12lld %12lld %14lld %14lld\n", (int)r + 1, round.seconds,
+                   round.candidates, round.crossPartition, round.bytesUp, round.bytesDown);
+        }
+    }
+    return 0;
+}
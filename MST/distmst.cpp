@@ -0,0 +1,379 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "distmst.h"
+
+/* IMPLEMENTATION OF distmst.h */
+
+
+/* Every message is a block: a count, then that many records.  A count of
+ -1 from the coordinator tells a worker to stop. */
+#define DIST_STOP -1
+
+
+/* write all len bytes of data to fd; false if the other end is gone */
+static bool sendAll(int fd, const void* data, size_t len){
+    const char* p = (const char*)data;
+    while(len > 0){
+        ssize_t sent = send(fd, p, len, MSG_NOSIGNAL);
+        if(sent < 0){
+            if(errno == EINTR){
+                continue;
+            }
+            return false;
+        }
+        p += sent;
+        len -= (size_t)sent;
+    }
+    return true;
+}
+
+
+/* read exactly len bytes from fd into data; false on error or end of file */
+static bool recvAll(int fd, void* data, size_t len){
+    char* p = (char*)data;
+    while(len > 0){
+        ssize_t got = read(fd, p, len);
+        if(got < 0 && errno == EINTR){
+            continue;
+        }
+        if(got <= 0){
+            return false;
+        }
+        p += got;
+        len -= (size_t)got;
+    }
+    return true;
+}
+
+
+/* send the records of block, adding the bytes sent to *bytes */
+template <typename T>
+static bool sendBlock(int fd, const std::vector<T>& block, long long* bytes){
+    long long count = (long long)block.size();
+    *bytes += (long long)(sizeof(count) + block.size() * sizeof(T));
+    return sendAll(fd, &count, sizeof(count))
+        && sendAll(fd, block.data(), block.size() * sizeof(T));
+}
+
+
+/* receive a block into block; *count is its count (DIST_STOP for a stop) */
+template <typename T>
+static bool recvBlock(int fd, std::vector<T>& block, long long* count){
+    if(!recvAll(fd, count, sizeof(*count))){
+        return false;
+    }
+    block.resize(*count > 0 ? (size_t)*count : 0);
+    return recvAll(fd, block.data(), block.size() * sizeof(T));
+}
+
+
+/* The order every step agrees on, as in parallelprim.cpp: by weight, then
+ by the lower end, then by the higher end (edges are kept with source < target). */
+template <typename W>
+static bool lighter(const typename BasicGraph<W>::Edge& a, const typename BasicGraph<W>::Edge& b){
+    if(a.weight != b.weight){
+        return a.weight < b.weight;
+    }
+    if(a.source != b.source){
+        return a.source < b.source;
+    }
+    return a.target < b.target;
+}
+
+
+/* what a worker sends: the cheapest edge it has out of component */
+template <typename W>
+struct candidate {
+    int component;
+    typename BasicGraph<W>::Edge e;
+};
+
+/* what the coordinator sends: component from is now part of component to */
+struct relabel {
+    int from;
+    int to;
+};
+
+
+/* The worker for vertices from .. to-1, talking to the coordinator on fd.
+ Returns when told to stop or when the coordinator is gone. */
+template <typename W>
+static void worker(const BasicGraph<W>* g, int from, int to, int fd){
+    typedef typename BasicGraph<W>::Edge Edge;
+    int n = g->numVerts();
+
+    //the edges out of my vertices, lower end first; the other ends may be anyone's
+    struct local {
+        Edge e;
+        int mine;   //my end
+        int other;  //the other end
+    };
+    std::vector<local> edges;
+    int* targets = new int[n];
+    W* weights = new W[n];
+    for(int v = from; v < to; v++){
+        int degree = g->successorEdges(v, targets, weights);
+        for(int index = 0; index < degree; index++){
+            int u = targets[index];
+            if(u != v){
+                local l = {{std::min(u, v), std::max(u, v), weights[index]}, v, u};
+                edges.push_back(l);
+            }
+        }
+    }
+    delete[] weights;
+    delete[] targets;
+
+    //component[v] is the label of v's component, for every v (my edges reach anywhere)
+    int* component = new int[n];
+    int* renamed = new int[n];
+    int* best = new int[n];
+    for(int v = 0; v < n; v++){
+        component[v] = v;
+        renamed[v] = v;
+        best[v] = -1;
+    }
+    std::vector<int> touched;
+    std::vector<candidate<W> > out;
+    std::vector<relabel> in;
+    long long unused = 0;
+    while(true){
+        //the cheapest of my edges out of each component
+        for(size_t i = 0; i < edges.size(); i++){
+            int c = component[edges[i].mine];
+            if(best[c] == -1){
+                touched.push_back(c);
+                best[c] = (int)i;
+            }
+            else if(lighter<W>(edges[i].e, edges[best[c]].e)){
+                best[c] = (int)i;
+            }
+        }
+        out.clear();
+        for(size_t i = 0; i < touched.size(); i++){
+            candidate<W> c = {touched[i], edges[best[touched[i]]].e};
+            out.push_back(c);
+            best[touched[i]] = -1;
+        }
+        touched.clear();
+        if(!sendBlock(fd, out, &unused)){
+            break;
+        }
+
+        //relabel the merged components and drop my edges now inside one
+        long long count;
+        if(!recvBlock(fd, in, &count) || count == DIST_STOP){
+            break;
+        }
+        for(size_t i = 0; i < in.size(); i++){
+            renamed[in[i].from] = in[i].to;
+        }
+        for(int v = 0; v < n; v++){
+            component[v] = renamed[component[v]];
+        }
+        for(size_t i = 0; i < in.size(); i++){
+            renamed[in[i].from] = in[i].from;
+        }
+        size_t kept = 0;
+        for(size_t i = 0; i < edges.size(); i++){
+            if(component[edges[i].mine] != component[edges[i].other]){
+                edges[kept++] = edges[i];
+            }
+        }
+        edges.resize(kept);
+    }
+    delete[] best;
+    delete[] renamed;
+    delete[] component;
+}
+
+
+/* union-find root of v with path halving */
+static int findSet(int* set, int v){
+    while(set[v] != v){
+        set[v] = set[set[v]];
+        v = set[v];
+    }
+    return v;
+}
+
+
+/* see distmst.h */
+template <typename W>
+unique_ptr<BasicGraph<W> > distributedMST(const BasicGraph<W>* g, int workers, DistStats* stats){
+    typedef typename BasicGraph<W>::Edge Edge;
+    int n = g->numVerts();
+    workers = std::max(1, std::min(workers, n));
+    if(stats != NULL){
+        stats->workers = workers;
+        stats->rounds.clear();
+    }
+
+    //start the workers, worker k on vertices first[k] .. first[k+1]-1
+    std::vector<int> first(workers + 1);
+    for(int k = 0; k <= workers; k++){
+        first[k] = (int)((long long)n * k / workers);
+    }
+    std::vector<int> fds;
+    std::vector<pid_t> pids;
+    bool ok = true;
+    fflush(NULL);  //or the children would flush the caller's buffered output again
+    for(int k = 0; k < workers && ok; k++){
+        int pair[2];
+        if(socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0){
+            ok = false;
+            break;
+        }
+        pid_t pid = fork();
+        if(pid == 0){
+            close(pair[0]);
+            for(size_t i = 0; i < fds.size(); i++){
+                close(fds[i]);
+            }
+            worker(g, first[k], first[k + 1], pair[1]);
+            close(pair[1]);
+            _exit(0);
+        }
+        close(pair[1]);
+        if(pid < 0){
+            close(pair[0]);
+            ok = false;
+            break;
+        }
+        fds.push_back(pair[0]);
+        pids.push_back(pid);
+    }
+
+    //Boruvka's rounds
+    int* set = new int[n];
+    int* best = new int[n];
+    for(int v = 0; v < n; v++){
+        set[v] = v;
+        best[v] = -1;
+    }
+    std::vector<int> roots;  //the components at the start of the round
+    for(int v = 0; v < n; v++){
+        roots.push_back(v);
+    }
+    std::vector<Edge> tree;
+    std::vector<candidate<W> > all, in;
+    std::vector<relabel> out;
+    std::chrono::steady_clock::time_point mark = std::chrono::steady_clock::now();
+    while(ok){
+        DistRound round = {0, 0, 0, 0, 0};
+
+        //every worker's candidates, and the cheapest for each component
+        all.clear();
+        for(int k = 0; k < workers && ok; k++){
+            long long count;
+            if(!recvBlock(fds[k], in, &count)){
+                ok = false;
+                break;
+            }
+            round.bytesUp += (long long)(sizeof(count) + in.size() * sizeof(candidate<W>));
+            round.candidates += (long long)in.size();
+            for(size_t i = 0; i < in.size(); i++){
+                const Edge& e = in[i].e;  //one end is worker k's
+                if(e.source < first[k] || e.target >= first[k + 1]){
+                    round.crossPartition++;
+                }
+                int c = in[i].component;
+                if(best[c] == -1){
+                    best[c] = (int)all.size();
+                    all.push_back(in[i]);
+                }
+                else if(lighter<W>(e, all[best[c]].e)){
+                    all[best[c]] = in[i];
+                }
+            }
+        }
+        if(!ok){
+            break;
+        }
+        for(size_t i = 0; i < all.size(); i++){
+            best[all[i].component] = -1;
+        }
+
+        //join each component along its cheapest edge
+        for(size_t i = 0; i < all.size(); i++){
+            int a = findSet(set, all[i].e.source);
+            int b = findSet(set, all[i].e.target);
+            if(a != b){  //else the component at the other end picked it already
+                set[b] = a;
+                tree.push_back(all[i].e);
+            }
+        }
+
+        //tell the workers which components merged, or to stop
+        out.clear();
+        size_t kept = 0;
+        for(size_t i = 0; i < roots.size(); i++){
+            int root = findSet(set, roots[i]);
+            if(root != roots[i]){
+                relabel r = {roots[i], root};
+                out.push_back(r);
+            }
+            else{
+                roots[kept++] = roots[i];
+            }
+        }
+        roots.resize(kept);
+        bool done = all.empty();
+        for(int k = 0; k < workers && ok; k++){
+            if(done){
+                long long stop = DIST_STOP;
+                round.bytesDown += (long long)sizeof(stop);
+                ok = sendAll(fds[k], &stop, sizeof(stop));
+            }
+            else{
+                ok = sendBlock(fds[k], out, &round.bytesDown);
+            }
+        }
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        round.seconds = std::chrono::duration<double>(now - mark).count();
+        mark = now;
+        if(stats != NULL){
+            stats->rounds.push_back(round);
+        }
+        if(done){
+            break;
+        }
+    }
+    delete[] best;
+    delete[] set;
+
+    //a worker that lost the coordinator stops on its own; reap them all
+    for(size_t k = 0; k < fds.size(); k++){
+        close(fds[k]);
+    }
+    for(size_t k = 0; k < pids.size(); k++){
+        int status;
+        while(waitpid(pids[k], &status, 0) < 0 && errno == EINTR){
+        }
+    }
+    if(!ok){
+        return unique_ptr<BasicGraph<W> >();
+    }
+
+    unique_ptr<BasicGraph<W> > MST(new BasicGraph<W>(n, ULIST));
+    MST->addEdges(tree.data(), (int)tree.size(), false);
+    return MST;
+}
+
+
+/* the weight types distributedMST is compiled for, same as BasicGraph in graph.cpp */
+#define DISTMST_INSTANTIATE(W) \
+    template unique_ptr<BasicGraph<W> > distributedMST<W>(const BasicGraph<W>*, int, DistStats*);
+
+DISTMST_INSTANTIATE(float)
+DISTMST_INSTANTIATE(double)
+DISTMST_INSTANTIATE(uint16_t)
+DISTMST_INSTANTIATE(uint32_t)
+DISTMST_INSTANTIATE(int64_t)
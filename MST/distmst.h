@@ -0,0 +1,70 @@
+#ifndef DISTMST_H
+#define DISTMST_H
+
+#include "graph.h"
+#include <vector>
+
+/* Minimum spanning tree by several worker processes, with Boruvka's
+ * algorithm run in rounds by a coordinator.
+ *
+ * The vertices are split into as many ranges of consecutive numbers as
+ * there are workers.  Each worker is a child process (fork) that keeps only
+ * the edges leaving its own vertices, and talks to the coordinator (the
+ * calling process) over a Unix socket pair.  Each round:
+ *  - every worker sends, for each component that has one of its vertices,
+ *    the cheapest edge out of that component among its edges (a candidate);
+ *  - the coordinator takes the cheapest candidate of each component, adds
+ *    those edges to the tree and merges the components with union-find;
+ *  - it sends every worker the merged components (old label -> new label)
+ *    and the workers relabel, dropping edges now inside a component.
+ * The number of components at least halves per round, so there are at
+ * most log2(V) rounds.  When no worker has a candidate, the coordinator
+ * stops the workers and returns the tree.
+ *
+ * Candidates and labels are the only messages, so the traffic per round is
+ * O(components) up to the coordinator and O(workers * merged components)
+ * down (every worker keeps the labels of all vertices, since its edges can
+ * lead anywhere), never O(E).  Edges are compared by weight, then
+ * lower end, then higher end, as in parallelprim.h, so the tree does not
+ * depend on the number of workers.
+ *
+ * The workers inherit g through fork and read only their own vertices'
+ * adjacency (the pages are shared with the coordinator until someone
+ * writes them).  Same assumptions as minSpanTree.
+ *
+ * NOT SAFE TO CALL FROM A MULTITHREADED PROCESS.  fork copies only the
+ * calling thread, and the workers allocate (new, std::vector) in the child:
+ * if another thread held the allocator's lock at the moment of the fork,
+ * it stays locked in the child and the worker hangs, and so does the
+ * coordinator waiting for it.  Call it before starting any threads, or
+ * after joining them all.
+ */
+
+
+/* Traffic of one round.  A candidate is cross-partition when its other end
+ * belongs to another worker.
+ */
+struct DistRound {
+    long long candidates;      //candidate edges sent to the coordinator
+    long long crossPartition;  //of those, edges between partitions
+    long long bytesUp;         //bytes the workers sent to the coordinator
+    long long bytesDown;       //bytes the coordinator sent to the workers
+    double seconds;            //wall time, from the end of the round before
+                               //(or the start of the workers) to the last send
+};
+
+struct DistStats {
+    int workers;                    //number of worker processes
+    std::vector<DistRound> rounds;  //one per round, the last one finds nothing
+};
+
+
+/* Return a minimum spanning tree (a forest if g is disconnected) as a new
+ * ULIST graph, computed by the given number of worker processes (at least
+ * 1, at most numVerts()).  If stats is not NULL, it is filled in.
+ * Returns NULL if a worker could not be started or a message was lost.
+ */
+template <typename W>
+unique_ptr<BasicGraph<W> > distributedMST(const BasicGraph<W>* g, int workers, DistStats* stats);
+
+#endif
@@ -0,0 +1,615 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits>
+#include <atomic>
+#include <algorithm>
+#include <vector>
+#include "graph.h"
+#include "primmst.h"
+#include "dispatch.h"
+#include "parallelprim.h"
+#include "distmst.h"
+#include "reorder.h"
+#include "secondbest.h"
+#include "cluster.h"
+#include "euclid.h"
+
+/*
+ * Checks the MST engines other than minSpanTree against it: every engine
+ * of dispatch.h and computeMST, minSpanTreeReordered in each order,
+ * parallelPrim on several thread counts and distributedMST on several
+ * worker counts.  The graphs are random: sparse
+ * and denser, weights with many ties, disconnected graphs with isolated
+ * vertices, and graphs without edges.  An answer passes when
+ * its edges are edges of the graph with the same weights, it has no cycle,
+ * and it has as many edges and the same total weight as minSpanTree's.
+ * The weights are whole numbers, or multiples of 1/4 for float, so the
+ * totals are exact.
+ *
+ * Also checks, on small graphs with bridges and several components,
+ * replacementEdges and secondBestTree against brute force (minSpanTree
+ * again without each tree edge), and the cuts of the single-linkage
+ * dendrogram against the components of the light edges; euclideanMST
+ * against minSpanTree on the complete graph of the points; and that a
+ * PrimBudget stops a run when cancelled or out of time, reports progress,
+ * and lets the next run go to the end.
+ *
+ * testAllFiles.sh builds and runs it; prints one line per failure and
+ * "Engine Checks: PASSED" or "Engine Checks: FAILED".
+ */
+
+#define CHECK_GRAPHS 24   /* random graphs per weight type */
+
+
+/* union-find root of v with path halving */
+static int findSet(std::vector<int>& set, int v){
+    while(set[v] != v){
+        set[v] = set[set[v]];
+        v = set[v];
+    }
+    return v;
+}
+
+
+/* A random graph of n vertices in representation rep, seeded with seed.
+ Shape 0: about 3n random edges; 1: about n*n/4 edges with weights 1 .. 3;
+ 2: the vertices in blocks of up to 16 with no edges between blocks, every
+ fifth vertex isolated; 3: no edges. */
+template <typename W>
+static unique_ptr<BasicGraph<W> > checkGraph(int n, int rep, int shape, unsigned int seed){
+    srand(seed);
+    unique_ptr<BasicGraph<W> > g(new BasicGraph<W>(n, rep));
+    long long edges = (shape == 0) ? 3LL * n : (shape == 1) ? (long long)n * n / 4 : (shape == 2) ? 4LL * n : 0;
+    for(long long k = 0; k < edges; k++){
+        int u = rand() % n, v = rand() % n;
+        if(shape == 2){
+            v = u - u % 16 + rand() % 16;
+            if(v >= n || u % 5 == 4 || v % 5 == 4){
+                continue;
+            }
+        }
+        if(u == v){
+            continue;
+        }
+        W w;
+        if(shape == 1){
+            w = (W)(1 + rand() % 3);
+        }else if(numeric_limits<W>::is_integer){
+            w = (W)(rand() % 100);
+        }else{
+            w = (W)((rand() % 400) / 4.0);
+        }
+        g->addEdge(u, v, w);
+        if(rep == LIST || rep == MATRIX){
+            g->addEdge(v, u, w);
+        }
+    }
+    return g;
+}
+
+
+/* The number of edges and total weight of tree, or false if tree is not a
+ forest of g's edges. */
+template <typename W>
+static bool measure(const BasicGraph<W>* g, const BasicGraph<W>* tree, int* count, double* total){
+    int n = g->numVerts();
+    if(tree == NULL || tree->numVerts() != n){
+        return false;
+    }
+    std::vector<int> set(n), targets(n);
+    std::vector<W> weights(n);
+    for(int v = 0; v < n; v++){
+        set[v] = v;
+    }
+    *count = 0;
+    *total = 0;
+    for(int v = 0; v < n; v++){
+        int degree = tree->successorEdges(v, targets.data(), weights.data());
+        for(int i = 0; i < degree; i++){
+            int u = targets[i];
+            if(u < v){
+                continue;  //each tree edge once
+            }
+            if(u == v || g->edge(v, u) != weights[i]){
+                return false;
+            }
+            int a = findSet(set, u), b = findSet(set, v);
+            if(a == b){
+                return false;  //a cycle
+            }
+            set[a] = b;
+            (*count)++;
+            *total += (double)weights[i];
+        }
+    }
+    return true;
+}
+
+
+/* minSpanTree's answer for a graph: what every engine must match */
+struct expected {
+    int graph;     //which of the random graphs, for the messages
+    int count;     //number of tree edges
+    double total;  //their total weight
+};
+
+
+/* compare tree with the expected answer for g; print and return false if it differs */
+template <typename W>
+static bool agrees(const BasicGraph<W>* g, const BasicGraph<W>* tree, const expected& answer,
+                   const char* what){
+    int count = 0;
+    double total = 0;
+    if(!measure(g, tree, &count, &total) || count != answer.count || total != answer.total){
+        printf("%s on graph %d (%d vertices): %d edges of weight %g, expected %d of weight %g\n",
+               what, answer.graph, g->numVerts(), count, total, answer.count, answer.total);
+        return false;
+    }
+    return true;
+}
+
+
+/* parallelPrim for 1 and several threads (more than the machine has is
+ fine: the claiming and merging are checked either way) */
+template <typename W>
+static bool checkParallel(const BasicGraph<W>* g, const expected& answer){
+    static const int threads[] = {1, 2, 4, 8};
+    bool ok = true;
+    for(int i = 0; i < (int)(sizeof(threads) / sizeof(threads[0])); i++){
+        unique_ptr<BasicGraph<W> > tree = parallelPrim(g, threads[i]);
+        char what[64];
+        snprintf(what, sizeof(what), "parallelPrim, %d threads", threads[i]);
+        ok = agrees(g, tree.get(), answer, what) && ok;
+    }
+    return ok;
+}
+
+
+/* every engine of dispatch.h through runEngine, and computeMST's own pick */
+template <typename W>
+static bool checkEngines(const BasicGraph<W>* g, const expected& answer){
+    bool ok = true;
+    for(int engine = 0; engine < MST_ENGINES; engine++){
+        unique_ptr<BasicGraph<W> > tree = runEngine(g, engine);
+        char what[64];
+        snprintf(what, sizeof(what), "runEngine %s", engineName(engine));
+        ok = agrees(g, tree.get(), answer, what) && ok;
+    }
+    MSTReport report;
+    unique_ptr<BasicGraph<W> > tree = computeMST(g, &report);
+    char what[64];
+    snprintf(what, sizeof(what), "computeMST (picked %s)", engineName(report.engine));
+    return agrees(g, tree.get(), answer, what) && ok;
+}
+
+
+/* vertexOrder is a permutation, and minSpanTreeReordered matches, for each order */
+template <typename W>
+static bool checkReorder(const BasicGraph<W>* g, const expected& answer){
+    static const int methods[] = {ORDER_BFS, ORDER_RCM, ORDER_DEGREE};
+    int n = g->numVerts();
+    bool ok = true;
+    for(int i = 0; i < (int)(sizeof(methods) / sizeof(methods[0])); i++){
+        unique_ptr<int[]> perm = vertexOrder(g, methods[i]);
+        std::vector<bool> hit(n, false);
+        for(int v = 0; v < n && perm != NULL; v++){
+            if(perm[v] < 0 || perm[v] >= n || hit[perm[v]]){
+                printf("vertexOrder %d on graph %d: not a permutation\n", methods[i], answer.graph);
+                ok = false;
+                break;
+            }
+            hit[perm[v]] = true;
+        }
+        unique_ptr<BasicGraph<W> > tree = minSpanTreeReordered(g, methods[i]);
+        char what[64];
+        snprintf(what, sizeof(what), "minSpanTreeReordered %d", methods[i]);
+        ok = (perm != NULL) && agrees(g, tree.get(), answer, what) && ok;
+    }
+    return ok;
+}
+
+
+/* distributedMST for 1 and several workers */
+template <typename W>
+static bool checkDistributed(const BasicGraph<W>* g, const expected& answer){
+    static const int workers[] = {1, 2, 3, 7};
+    bool ok = true;
+    for(int i = 0; i < (int)(sizeof(workers) / sizeof(workers[0])); i++){
+        DistStats stats;
+        unique_ptr<BasicGraph<W> > tree = distributedMST(g, workers[i], &stats);
+        char what[64];
+        snprintf(what, sizeof(what), "distributedMST, %d workers", workers[i]);
+        ok = agrees(g, tree.get(), answer, what) && ok;
+    }
+    return ok;
+}
+
+
+template <typename W>
+static bool checkAll(unsigned int seed){
+    static const int reps[] = {LIST, ULIST, MATRIX, UMATRIX};
+    bool ok = true;
+    for(int graph = 0; graph < CHECK_GRAPHS; graph++){
+        int n = (graph % 4 == 3) ? 1 + graph % 5 : 50 + 37 * graph;
+        unique_ptr<BasicGraph<W> > g = checkGraph<W>(n, reps[graph / 4 % 4], graph % 4, seed + graph);
+        expected answer = {graph, 0, 0};
+        unique_ptr<BasicGraph<W> > reference = minSpanTree(g.get());
+        if(!measure(g.get(), reference.get(), &answer.count, &answer.total)){
+            printf("minSpanTree on graph %d: not a forest of the graph's edges\n", graph);
+            ok = false;
+            continue;
+        }
+        ok = checkEngines(g.get(), answer) && ok;
+        ok = checkReorder(g.get(), answer) && ok;
+        ok = checkParallel(g.get(), answer) && ok;
+        ok = checkDistributed(g.get(), answer) && ok;
+    }
+    return ok;
+}
+
+
+/* A small ULIST graph for the brute force checks: vertex v > 0 hangs off a
+ random lower vertex (so there are bridges), except now and then, which
+ leaves several components, plus n/2 random extra edges; weights 1 .. 5, so
+ there are many ties. */
+template <typename W>
+static unique_ptr<BasicGraph<W> > smallGraph(int n, unsigned int seed){
+    srand(seed);
+    unique_ptr<BasicGraph<W> > g(new BasicGraph<W>(n, ULIST));
+    for(int v = 1; v < n; v++){
+        if(rand() % 8 != 0){
+            g->addEdge(v, rand() % v, (W)(1 + rand() % 5));
+        }
+    }
+    for(int k = 0; k < n / 2; k++){
+        int u = rand() % n, v = rand() % n;
+        if(u != v){
+            g->addEdge(u, v, (W)(1 + rand() % 5));
+        }
+    }
+    return g;
+}
+
+
+/* the edges of a ULIST graph, each once */
+template <typename W>
+static std::vector<typename BasicGraph<W>::Edge> edgeList(const BasicGraph<W>* g){
+    int n = g->numVerts();
+    std::vector<typename BasicGraph<W>::Edge> edges;
+    std::vector<int> targets(n);
+    std::vector<W> weights(n);
+    for(int v = 0; v < n; v++){
+        int degree = g->successorEdges(v, targets.data(), weights.data());
+        for(int i = 0; i < degree; i++){
+            if(v < targets[i]){
+                typename BasicGraph<W>::Edge e = {v, targets[i], weights[i]};
+                edges.push_back(e);
+            }
+        }
+    }
+    return edges;
+}
+
+
+/* replacementEdges and secondBestTree against removing each tree edge from
+ g and running minSpanTree again */
+template <typename W>
+static bool checkSecondBest(unsigned int seed){
+    bool ok = true;
+    for(int graph = 0; graph < 40; graph++){
+        int n = 2 + graph % 11;
+        unique_ptr<BasicGraph<W> > g = smallGraph<W>(n, seed + graph);
+        unique_ptr<BasicGraph<W> > tree = minSpanTree(g.get());
+        expected answer = {graph, 0, 0};
+        measure(g.get(), tree.get(), &answer.count, &answer.total);
+        std::vector<typename BasicGraph<W>::Edge> all = edgeList(g.get());
+
+        //brute force: the best forest without each tree edge, INFINITY if it has fewer edges
+        std::vector<basicreplacement<W> > found = replacementEdges(g.get(), tree.get());
+        double best = INFINITY;
+        if((int)found.size() != answer.count){
+            printf("replacementEdges on graph %d: %d entries for %d tree edges\n",
+                   graph, (int)found.size(), answer.count);
+            ok = false;
+            continue;
+        }
+        for(size_t i = 0; i < found.size(); i++){
+            basicreplacement<W>& r = found[i];
+            unique_ptr<BasicGraph<W> > without(new BasicGraph<W>(n, ULIST));
+            for(size_t k = 0; k < all.size(); k++){
+                bool removed = (all[k].source == r.source && all[k].target == r.target)
+                            || (all[k].source == r.target && all[k].target == r.source);
+                if(!removed){
+                    without->addEdge(all[k].source, all[k].target, all[k].weight);
+                }
+            }
+            unique_ptr<BasicGraph<W> > rest = minSpanTree(without.get());
+            int count;
+            double total;
+            measure(without.get(), rest.get(), &count, &total);
+            double expect = (count < answer.count) ? INFINITY : total;
+            bool bridge = (count < answer.count);
+            bool right = g->edge(r.source, r.target) == r.weight && r.totalWeight == expect
+                         && (bridge ? r.replSource == -1 && r.replTarget == -1
+                                    : g->edge(r.replSource, r.replTarget) == r.replWeight
+                                      && tree->edge(r.replSource, r.replTarget) == WeightTraits<W>::noEdge());
+            if(!right){
+                printf("replacementEdges on graph %d, edge %d-%d: total %g, expected %g\n",
+                       graph, r.source, r.target, r.totalWeight, expect);
+                ok = false;
+            }
+            if(expect < best){
+                best = expect;
+            }
+        }
+
+        //the second best tree is the cheapest of those, and not the tree itself
+        double total = -1;
+        unique_ptr<BasicGraph<W> > second = secondBestTree(g.get(), tree.get(), &total);
+        if(best == INFINITY){
+            if(second != NULL){
+                printf("secondBestTree on graph %d: a tree, but every tree edge is a bridge\n", graph);
+                ok = false;
+            }
+            continue;
+        }
+        expected secondAnswer = {graph, answer.count, best};
+        bool differs = false;
+        std::vector<typename BasicGraph<W>::Edge> edges = (second == NULL) ? all : edgeList(second.get());
+        for(size_t k = 0; k < edges.size() && second != NULL; k++){
+            differs = differs || tree->edge(edges[k].source, edges[k].target) == WeightTraits<W>::noEdge();
+        }
+        if(second == NULL || total != best || !differs
+           || !agrees(g.get(), second.get(), secondAnswer, "secondBestTree")){
+            printf("secondBestTree on graph %d: weight %g, expected %g\n", graph, total, best);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+
+/* true if label numbers its clusters 0, 1, ... in order of their lowest
+ vertex and uses count numbers */
+static bool canonical(const std::vector<int>& label, int count){
+    int next = 0;
+    for(size_t v = 0; v < label.size(); v++){
+        if(label[v] > next || label[v] < 0){
+            return false;
+        }
+        if(label[v] == next){
+            next++;
+        }
+    }
+    return next == count;
+}
+
+
+/* Dendrogram cuts: cutThreshold(d) gives the components of the edges of
+ weight <= d, and cutK(k) gives k clusters (clamped to the number of
+ components and n), each inside a cluster of cutK(k-1) */
+template <typename W>
+static bool checkClusters(unsigned int seed){
+    bool ok = true;
+    for(int graph = 0; graph < 30; graph++){
+        int n = 2 + graph % 13;
+        unique_ptr<BasicGraph<W> > g = smallGraph<W>(n, seed + graph);
+        unique_ptr<Dendrogram<W> > tree = singleLinkage(g.get());
+        std::vector<typename BasicGraph<W>::Edge> all = edgeList(g.get());
+        std::vector<int> label(n), set(n), expect(n), previous;
+
+        int components = 0;
+        for(int d = 0; d <= 6; d++){
+            //the components of the edges of weight <= d, numbered by lowest vertex
+            for(int v = 0; v < n; v++){
+                set[v] = v;
+            }
+            for(size_t k = 0; k < all.size(); k++){
+                if(all[k].weight <= (W)d){
+                    set[findSet(set, all[k].source)] = findSet(set, all[k].target);
+                }
+            }
+            std::vector<int> number(n, -1);
+            int count = 0;
+            for(int v = 0; v < n; v++){
+                int root = findSet(set, v);
+                if(number[root] == -1){
+                    number[root] = count++;
+                }
+                expect[v] = number[root];
+            }
+            components = count;  //the last, d = 6, is above every weight
+            if(tree->cutThreshold((W)d, label.data()) != count || label != expect){
+                printf("cutThreshold(%d) on graph %d: not the components of the edges <= %d\n", d, graph, d);
+                ok = false;
+            }
+        }
+
+        for(int k = n + 1; k >= 0; k--){
+            int want = (k > n) ? n : (k < components) ? components : k;
+            int got = tree->cutK(k, label.data());
+            bool nested = true;
+            for(int v = 0; v < n && !previous.empty(); v++){
+                for(int u = 0; u < v; u++){
+                    if(previous[u] == previous[v] && label[u] != label[v]){
+                        nested = false;
+                    }
+                }
+            }
+            if(got != want || !canonical(label, got) || !nested){
+                printf("cutK(%d) on graph %d: %d clusters, expected %d\n", k, graph, got, want);
+                ok = false;
+            }
+            previous = label;
+        }
+    }
+    return ok;
+}
+
+
+/* the weights of the edges of a ULIST tree, sorted: the same for every
+ minimum spanning tree of a graph, so they compare exactly */
+template <typename W>
+static std::vector<W> sortedWeights(const BasicGraph<W>* tree){
+    std::vector<typename BasicGraph<W>::Edge> edges = edgeList(tree);
+    std::vector<W> weights;
+    for(size_t k = 0; k < edges.size(); k++){
+        weights.push_back(edges[k].weight);
+    }
+    std::sort(weights.begin(), weights.end());
+    return weights;
+}
+
+
+/* euclideanMST against minSpanTree on the complete MATRIX graph of the
+ points, with the distances computed the same way.  The coordinates are
+ halves from 0 to 2, so there are duplicate points and many equal
+ distances. */
+template <typename W, int D>
+static bool checkEuclid(const char* type, unsigned int seed){
+    bool ok = true;
+    for(int set = 0; set < 8; set++){
+        srand(seed + set);
+        int n = 1 + set * 9;
+        std::vector<W> coords(n * D);
+        for(int i = 0; i < n * D; i++){
+            coords[i] = (W)((rand() % 5) / 2.0);
+        }
+        unique_ptr<BasicGraph<W> > complete(new BasicGraph<W>(n, MATRIX));
+        for(int i = 0; i < n; i++){
+            for(int j = 0; j < n; j++){
+                double sum = 0;
+                for(int d = 0; d < D; d++){
+                    double diff = (double)coords[i * D + d] - coords[j * D + d];
+                    sum += diff * diff;
+                }
+                if(i != j){
+                    complete->addEdge(i, j, (W)sqrt(sum));
+                }
+            }
+        }
+        unique_ptr<BasicGraph<W> > reference = minSpanTree(complete.get());
+        unique_ptr<BasicGraph<W> > tree = euclideanMST<W, D>(coords.data(), n);
+        int count;
+        double total;
+        if(!measure(complete.get(), tree.get(), &count, &total) || count != n - 1
+           || sortedWeights(tree.get()) != sortedWeights(reference.get())){
+            printf("euclideanMST<%s, %d> on %d points: not a minimum spanning tree\n", type, D, n);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+
+/* what a PrimBudget reported: every fraction, in order; when one reaches
+ cancelAt, *token is set */
+struct progressLog {
+    std::vector<double> fractions;
+    double cancelAt;
+    std::atomic<bool>* token;
+};
+
+static void logProgress(double fraction, void* context){
+    progressLog* log = (progressLog*)context;
+    log->fractions.push_back(fraction);
+    if(fraction >= log->cancelAt){
+        log->token->store(true);
+    }
+}
+
+
+/* true if tree is a forest of edges of g with fewer than most edges, and
+ the fractions logged are the k-th check of the first calls of a run */
+template <typename W>
+static bool partial(const BasicGraph<W>* g, const BasicGraph<W>* tree, int most,
+                    const progressLog& log, int calls){
+    int count;
+    double total;
+    if(!measure(g, tree, &count, &total) || count <= 0 || count >= most
+       || (int)log.fractions.size() != calls){
+        return false;
+    }
+    for(int k = 0; k < calls; k++){
+        if(log.fractions[k] != (double)(k + 1) * PRIM_CHECK_INTERVAL / g->numVerts()){
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/* PrimBudget on a graph big enough for a few checks: a token set before
+ the run stops it at the first check, one set from the progress function
+ at the check that reports it, and a deadline already passed at the first
+ check, each leaving the tree of the vertices finalized so far.  After
+ each, a run with the same budget, the token cleared or the deadline far
+ off, goes to the end with the whole tree and reports every check and 1.
+ The heap and the bucket queue (integer weights) check the same way. */
+template <typename W>
+static bool checkBudget(unsigned int seed){
+    int n = 3 * PRIM_CHECK_INTERVAL + 100;
+    unique_ptr<BasicGraph<W> > g = checkGraph<W>(n, ULIST, 0, seed);
+    expected answer = {0, 0, 0};
+    unique_ptr<BasicGraph<W> > reference = minSpanTree(g.get());
+    measure(g.get(), reference.get(), &answer.count, &answer.total);
+
+    std::atomic<bool> token(false);
+    progressLog log;
+    log.token = &token;
+    PrimBudget budget;
+    budget.setProgress(logProgress, &log);
+    bool ok = true;
+    for(int way = 0; way < 3; way++){
+        log.fractions.clear();
+        log.cancelAt = (way == 1) ? 0.5 : 2;
+        token.store(way == 0);
+        budget.setCancel(way < 2 ? &token : NULL);
+        if(way == 2){
+            budget.setDeadline(0);
+        }
+        unique_ptr<BasicGraph<W> > tree = minSpanTree(g.get(), budget);
+        int checks = (way == 1) ? 2 : 1;
+        if(budget.cancelled() != (way < 2) || budget.timedOut() != (way == 2)
+           || !partial(g.get(), tree.get(), checks * PRIM_CHECK_INTERVAL, log, checks)){
+            printf("PrimBudget, way %d: did not stop with a partial tree at check %d\n", way, checks);
+            ok = false;
+        }
+
+        log.fractions.clear();
+        log.cancelAt = 2;
+        token.store(false);
+        budget.setDeadline(3600);
+        tree = minSpanTree(g.get(), budget);
+        bool whole = !budget.stopped() && (int)log.fractions.size() == n / PRIM_CHECK_INTERVAL + 1
+                     && log.fractions.back() == 1.0;
+        if(!whole){
+            printf("PrimBudget, way %d: the next run did not go to the end\n", way);
+            ok = false;
+        }
+        ok = agrees(g.get(), tree.get(), answer, "minSpanTree with a PrimBudget") && ok;
+    }
+    return ok;
+}
+
+
+int main(int argc, char* argv[]){
+    bool ok = checkAll<float>(1000);
+    ok = checkAll<uint32_t>(2000) && ok;
+    ok = checkSecondBest<float>(3000) && ok;
+    ok = checkSecondBest<uint32_t>(4000) && ok;
+    ok = checkClusters<float>(5000) && ok;
+    ok = checkClusters<uint32_t>(6000) && ok;
+    ok = checkEuclid<float, 1>("float", 7000) && ok;
+    ok = checkEuclid<float, 2>("float", 7100) && ok;
+    ok = checkEuclid<float, 3>("float", 7200) && ok;
+    ok = checkEuclid<float, 4>("float", 7300) && ok;
+    ok = checkEuclid<double, 1>("double", 7400) && ok;
+    ok = checkEuclid<double, 2>("double", 7500) && ok;
+    ok = checkEuclid<double, 3>("double", 7600) && ok;
+    ok = checkEuclid<double, 4>("double", 7700) && ok;
+    ok = checkBudget<float>(8000) && ok;
+    ok = checkBudget<uint32_t>(8100) && ok;
+    printf("Engine Checks: %s\n", ok ? "PASSED" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,274 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "euclid.h"
+
+/* IMPLEMENTATION OF euclid.h */
+
+
+/* points per k-d tree leaf */
+#define KD_LEAF_SIZE 8
+
+
+/* A node of the k-d tree: points begin .. end-1 (in tree order) and their
+ bounding box.  Children of node i are left and left+1, or -1 for a leaf. */
+template <typename W, int D>
+struct KDNode {
+    int begin;
+    int end;
+    int left;
+    int comp;    //component of all points below, or -1 if they differ
+    W lo[D];
+    W hi[D];
+};
+
+
+/* The k-d tree, with the points copied in tree order so that the points of
+ a node are next to each other in memory. */
+template <typename W, int D>
+struct KDTree {
+    std::vector<KDNode<W, D> > nodes;
+    W* point;    //point[i*D .. i*D+D-1] is the i-th point in tree order
+    int* id;     //id[i] is its number in the input
+};
+
+
+/* Build the subtree of node for its points: split at the median of the
+ widest side of the bounding box, until KD_LEAF_SIZE points are left. */
+template <typename W, int D>
+static void buildKD(KDTree<W, D>& kd, int node, const W* coords){
+    KDNode<W, D>* nd = &kd.nodes[node];
+    for(int d = 0; d < D; d++){
+        nd->lo[d] = nd->hi[d] = coords[kd.id[nd->begin] * D + d];
+    }
+    for(int i = nd->begin + 1; i < nd->end; i++){
+        for(int d = 0; d < D; d++){
+            W c = coords[kd.id[i] * D + d];
+            nd->lo[d] = std::min(nd->lo[d], c);
+            nd->hi[d] = std::max(nd->hi[d], c);
+        }
+    }
+    nd->left = -1;
+    nd->comp = -1;
+    if(nd->end - nd->begin <= KD_LEAF_SIZE){
+        return;
+    }
+
+    int axis = 0;
+    for(int d = 1; d < D; d++){
+        if(nd->hi[d] - nd->lo[d] > nd->hi[axis] - nd->lo[axis]){
+            axis = d;
+        }
+    }
+    int begin = nd->begin, end = nd->end, mid = (begin + end) / 2;
+    std::nth_element(kd.id + begin, kd.id + mid, kd.id + end,
+                     [coords, axis](int a, int b){ return coords[a * D + axis] < coords[b * D + axis]; });
+
+    int left = (int)kd.nodes.size();
+    kd.nodes.resize(left + 2);  //nd is invalid from here on
+    kd.nodes[node].left = left;
+    kd.nodes[left].begin = begin;
+    kd.nodes[left].end = mid;
+    kd.nodes[left + 1].begin = mid;
+    kd.nodes[left + 1].end = end;
+    buildKD(kd, left, coords);
+    buildKD(kd, left + 1, coords);
+}
+
+
+/* squared distance from p to the box of nd, 0 inside it */
+template <typename W, int D>
+static double boxDistance(const KDNode<W, D>& nd, const W* p){
+    double sum = 0;
+    for(int d = 0; d < D; d++){
+        double gap = 0;
+        if(p[d] < nd.lo[d]){
+            gap = (double)nd.lo[d] - p[d];
+        }else if(p[d] > nd.hi[d]){
+            gap = (double)p[d] - nd.hi[d];
+        }
+        sum += gap * gap;
+    }
+    return sum;
+}
+
+
+/* squared distance between points i and j, in tree order */
+template <typename W, int D>
+static double pointDistance(const KDTree<W, D>& kd, int i, int j){
+    double sum = 0;
+    for(int d = 0; d < D; d++){
+        double diff = (double)kd.point[i * D + d] - kd.point[j * D + d];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+
+/* The best edge leaving a component so far: squared length and its two
+ ends (in tree order), or to == -1 if none yet.  Ties go to the smaller
+ pair of input numbers, so every component picks consistently. */
+struct Candidate {
+    double dist;
+    int from;
+    int to;
+};
+
+template <typename W, int D>
+static bool better(const KDTree<W, D>& kd, double dist, int from, int to, const Candidate& c){
+    if(c.to == -1 || dist < c.dist){
+        return true;
+    }
+    if(dist > c.dist){
+        return false;
+    }
+    int a = std::min(kd.id[from], kd.id[to]), b = std::max(kd.id[from], kd.id[to]);
+    int ca = std::min(kd.id[c.from], kd.id[c.to]), cb = std::max(kd.id[c.from], kd.id[c.to]);
+    return a < ca || (a == ca && b < cb);
+}
+
+
+/* Search below node for the nearest point to q that is not in component
+ comp, improving best.  Subtrees entirely in comp, or farther than best,
+ are skipped; of two children the nearer is searched first. */
+template <typename W, int D>
+static void nearestOther(const KDTree<W, D>& kd, int node, int q, int comp,
+                         const int* compOf, Candidate& best){
+    const KDNode<W, D>& nd = kd.nodes[node];
+    if(nd.comp == comp){
+        return;
+    }
+    const W* p = kd.point + q * D;
+    if(best.to != -1 && boxDistance(nd, p) > best.dist){
+        return;
+    }
+    if(nd.left == -1){
+        for(int i = nd.begin; i < nd.end; i++){
+            if(compOf[i] != comp){
+                double dist = pointDistance(kd, q, i);
+                if(better(kd, dist, q, i, best)){
+                    best.dist = dist;
+                    best.from = q;
+                    best.to = i;
+                }
+            }
+        }
+        return;
+    }
+    int near = nd.left, far = nd.left + 1;
+    if(boxDistance(kd.nodes[far], p) < boxDistance(kd.nodes[near], p)){
+        std::swap(near, far);
+    }
+    nearestOther(kd, near, q, comp, compOf, best);
+    nearestOther(kd, far, q, comp, compOf, best);
+}
+
+
+/* union-find root of v with path halving */
+static int findSet(int* set, int v){
+    while(set[v] != v){
+        set[v] = set[set[v]];
+        v = set[v];
+    }
+    return v;
+}
+
+
+/* see euclid.h */
+template <typename W, int D>
+unique_ptr<BasicGraph<W> > euclideanMST(const W* coords, int n){
+    unique_ptr<BasicGraph<W> > MST(new BasicGraph<W>(n, ULIST));
+    if(n < 2){
+        return MST;
+    }
+
+    KDTree<W, D> kd;
+    kd.id = new int[n];
+    for(int i = 0; i < n; i++){
+        kd.id[i] = i;
+    }
+    kd.nodes.reserve(2 * (n / KD_LEAF_SIZE + 1));
+    kd.nodes.resize(1);
+    kd.nodes[0].begin = 0;
+    kd.nodes[0].end = n;
+    buildKD(kd, 0, coords);
+    kd.point = new W[n * D];
+    for(int i = 0; i < n; i++){
+        for(int d = 0; d < D; d++){
+            kd.point[i * D + d] = coords[kd.id[i] * D + d];
+        }
+    }
+
+    //everything below is in tree order; compOf[i] is the union-find root of i
+    int* set = new int[n];
+    int* compOf = new int[n];
+    Candidate* best = new Candidate[n];
+    for(int i = 0; i < n; i++){
+        set[i] = compOf[i] = i;
+    }
+    std::vector<typename BasicGraph<W>::Edge> edges;
+    edges.reserve(n - 1);
+
+    while((int)edges.size() < n - 1){
+        //which nodes lie in a single component; children come after parents
+        for(int node = (int)kd.nodes.size() - 1; node >= 0; node--){
+            KDNode<W, D>& nd = kd.nodes[node];
+            if(nd.left == -1){
+                nd.comp = compOf[nd.begin];
+                for(int i = nd.begin + 1; i < nd.end && nd.comp != -1; i++){
+                    if(compOf[i] != nd.comp){
+                        nd.comp = -1;
+                    }
+                }
+            }else{
+                int a = kd.nodes[nd.left].comp, b = kd.nodes[nd.left + 1].comp;
+                nd.comp = (a == b) ? a : -1;
+            }
+        }
+
+        for(int i = 0; i < n; i++){
+            best[i].to = -1;
+        }
+        for(int i = 0; i < n; i++){
+            nearestOther(kd, 0, i, compOf[i], compOf, best[compOf[i]]);
+        }
+
+        for(int c = 0; c < n; c++){
+            if(compOf[c] != c || best[c].to == -1){
+                continue;
+            }
+            int a = findSet(set, best[c].from), b = findSet(set, best[c].to);
+            if(a == b){
+                continue;  //the other component picked the same edge
+            }
+            set[a] = b;
+            typename BasicGraph<W>::Edge e = {kd.id[best[c].from], kd.id[best[c].to],
+                                              (W)sqrt(best[c].dist)};
+            edges.push_back(e);
+        }
+        for(int i = 0; i < n; i++){
+            compOf[i] = findSet(set, i);
+        }
+    }
+
+    MST->addEdges(edges.data(), (int)edges.size(), false);
+    delete[] best;
+    delete[] compOf;
+    delete[] set;
+    delete[] kd.point;
+    delete[] kd.id;
+    return MST;
+}
+
+
+/* the coordinate types and dimensions euclideanMST is compiled for */
+#define EUCLID_INSTANTIATE(W) \
+    template unique_ptr<BasicGraph<W> > euclideanMST<W, 1>(const W*, int); \
+    template unique_ptr<BasicGraph<W> > euclideanMST<W, 2>(const W*, int); \
+    template unique_ptr<BasicGraph<W> > euclideanMST<W, 3>(const W*, int); \
+    template unique_ptr<BasicGraph<W> > euclideanMST<W, 4>(const W*, int);
+
+EUCLID_INSTANTIATE(float)
+EUCLID_INSTANTIATE(double)
@@ -0,0 +1,33 @@
+#ifndef EUCLID_H
+#define EUCLID_H
+
+#include "graph.h"
+
+/* Minimum spanning tree of a set of points under Euclidean distance,
+ * without building the complete graph.
+ *
+ * Making a MATRIX of all V^2 distances and calling minSpanTree takes
+ * O(V^2) time and memory.  Here the points go into a k-d tree instead, and
+ * the tree is found by Boruvka's algorithm: each round, every component
+ * finds its nearest point in another component by k-d tree searches, and all
+ * those edges are added at once; the number of components at least halves
+ * per round.  Each k-d tree node remembers whether all its points are in
+ * one component, so searches skip the parts of the space where the answer
+ * cannot be, and a component's best distance so far (shared by the searches
+ * from all its points) cuts the rest short.  About O(V log V) time per
+ * round for well spread points, and O(V) memory.
+ *
+ * The points are coords[0 .. D-1] for point 0, coords[D .. 2D-1] for point
+ * 1, and so on.  Compiled for float and double coordinates and D = 1 .. 4.
+ */
+
+
+/* Return a Euclidean minimum spanning tree of the n points, as a new ULIST
+ * graph with the distances as weights, the same kind of tree minSpanTree
+ * returns for the complete graph of the points.  Equal distances are broken
+ * the same way every time (by point numbers), so the result is deterministic.
+ */
+template <typename W, int D>
+unique_ptr<BasicGraph<W> > euclideanMST(const W* coords, int n);
+
+#endif
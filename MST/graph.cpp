@@ -11,124 +11,354 @@
 #include <math.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <thread>
+#include <vector>
 #include "graph.h"
+#include "graphrep.h"
 
-struct Graph::Node {
-  int val;
-  float weight;
-  Node* next;
-};
+/* the "no edge" weight, see graph.h */
+#define NONE (WeightTraits<W>::noEdge())
+
+/* occupancy bitmaps of a MATRIX graph: one bit per matrix cell, set when
+   the cell holds an edge.  rowBits is row major, so the words of row s are
+   rowBits[s*words .. s*words+words-1]; colBits is column major.  successors
+   and predecessors scan these 64 cells at a time instead of the weights. */
+#define ROWWORD(s,t) (rowBits[(size_t)(s)*words + (t)/64])
+#define COLWORD(s,t) (colBits[(size_t)(t)*words + (s)/64])
+#define CELLBIT(i) (1ULL << ((i) % 64))
+
+/* LIST nodes come from an arena of chunks owned by the graph: chunk i holds
+   NODE_CHUNK_MIN << i nodes, up to NODE_CHUNK_MAX, and nodes are handed out in
+   order, so the edges are contiguous in the order they were added.  delEdge
+   puts nodes on a free list (linked through next) for later addEdges, and the
+   destructor frees whole chunks. */
+#define NODE_CHUNK_MIN 64
+#define NODE_CHUNK_MAX 65536
+
+/* cloneGraph runs on several threads when the graph has at least this many edges */
+#define CLONE_PARALLEL_MIN (1 << 16)
+
+/* Run f(from, to) on the ranges of a split of 0 .. n-1 into one piece per
+   hardware thread (all on this thread when parallel is false). */
+template <typename F>
+static void parallelRanges(int n, bool parallel, F f){
+  int threads = parallel ? (int)std::thread::hardware_concurrency() : 1;
+  if(threads < 1){
+    threads = 1;
+  }
+  if(threads > n){
+    threads = n;
+  }
+  if(threads <= 1){
+    f(0, n);
+    return;
+  }
+  std::vector<std::thread> pool;
+  for(int t = 0; t < threads; t++){
+    int from = (int)((long long)n*t/threads);
+    int to = (int)((long long)n*(t+1)/threads);
+    pool.push_back(std::thread(f, from, to));
+  }
+  for(size_t t = 0; t < pool.size(); t++){
+    pool[t].join();
+  }
+}
 
 /* make an empty graph with n vertices,
 using either adjacency matrix or adjacency lists
 depending on whether rep==MATRIX or rep==LIST
 Precondition: n>=1 and rep is MATRIX or LIST.
 */
-Graph::Graph (int n, int rep){
+template <typename W>
+BasicGraph<W>::BasicGraph (int n, int rep){
   if ( n < 1){
     numVertices = 1;
     n=1;
   }else{
     numVertices = n;
   }
-  if(rep != MATRIX && rep!=LIST){
+  if(rep != MATRIX && rep!=LIST && rep != UMATRIX && rep != ULIST){
     type = MATRIX;
   }else{
     type = rep;
   }
  
-  if(rep == MATRIX){
+  words = (n + 63) / 64;
+  uedges = NULL;
+  numUEdges = maxUEdges = 0;
+  freeUEdges = -1;
+  uhead = utail = NULL;
+  if(type == UMATRIX || type == ULIST){
     list = NULL;
-    matrix = new float[n*n];
-    int index;
-    for(index=0; index<(n*n); index++){
-      matrix[index] = INFINITY;
+    chunks = NULL;
+    numChunks = maxChunks = chunkFill = 0;
+    freeNodes = NULL;
+    matrix = NULL;
+    rowBits = colBits = NULL;
+    if(type == UMATRIX){
+      //upper triangle including the diagonal; the bitmap is the full square
+      matrix = new W[triangleSize(n)];
+      for(size_t index=0; index<triangleSize(n); index++){
+        matrix[index] = NONE;
+      }
+      rowBits = new uint64_t[(size_t)n*words];
+      for(size_t index=0; index<(size_t)n*words; index++){
+        rowBits[index] = 0;
+      }
+    }else{
+      uhead = new int[n];
+      utail = new int[n];
+      for(int index=0; index<n; index++){
+        uhead[index] = utail[index] = -1;
+      }
+    }
+  }else if(type == MATRIX){
+    list = NULL;
+    chunks = NULL;
+    numChunks = maxChunks = chunkFill = 0;
+    freeNodes = NULL;
+    matrix = new W[(size_t)n*n];
+    size_t index;
+    for(index=0; index<(size_t)n*n; index++){
+      matrix[index] = NONE;
+    }
+    rowBits = new uint64_t[(size_t)n*words];
+    colBits = new uint64_t[(size_t)n*words];
+    for(index=0; index<(size_t)n*words; index++){
+      rowBits[index] = colBits[index] = 0;
     }
   }else {
     list = new Node*[n];
+    chunks = NULL;
+    numChunks = maxChunks = chunkFill = 0;
+    freeNodes = NULL;
     int index;
     for (index=0; index<numVertices; index++){
       
       list[index] = NULL;
     }
     matrix = NULL;
+    rowBits = colBits = NULL;
   }
 }
 
 /* make a copy of G, but using the representation
    specified by rep (which is assumed to be MATRIX or LIST) 
 */
-Graph* Graph::cloneGraph(int rep){
-  if(rep != MATRIX && rep!=LIST){
+template <typename W>
+unique_ptr<BasicGraph<W> > BasicGraph<W>::cloneGraph(int rep) const{
+  if(rep != MATRIX && rep!=LIST && rep != UMATRIX && rep != ULIST){
     return NULL;
   }
-  Graph* g = new Graph(numVertices,rep);
+  unique_ptr<BasicGraph<W> > g(new BasicGraph<W>(numVertices,rep));
  
   int n = g->numVerts();
-    
-  /*go through old graph and add nodes to the new one */
-  int src; int tgt;
-  for (src=0; src < n; src++){
-    for(tgt = 0; tgt<n; tgt++){
-      g->addEdge(src, tgt ,edge(src, tgt)); 
+
+  /*collect the edges of the old graph, the edges of source v going to
+    edges[start[v] .. start[v+1]-1]; each thread does a range of sources */
+  int* start = new int[n+1];
+  start[0] = 0;
+  //the degrees are counted on this thread: the edge count that decides on threads is not known yet
+  for(int v = 0; v < n; v++){
+    start[v+1] = outDegree(v);
+  }
+  for(int v = 0; v < n; v++){
+    start[v+1] += start[v];
+  }
+  int m = start[n];
+  bool parallel = (m >= CLONE_PARALLEL_MIN);
+  Edge* edges = new Edge[m > 0 ? m : 1];
+  parallelRanges(n, parallel, [&](int from, int to){
+    int* targets = new int[n];
+    W* weights = new W[n];
+    for(int v = from; v < to; v++){
+      int d = successorEdges(v, targets, weights);
+      for(int i = 0; i < d; i++){
+        Edge& e = edges[start[v] + i];
+        e.source = v;
+        e.target = targets[i];
+        e.weight = weights[i];
+      }
     }
+    delete[] weights;
+    delete[] targets;
+  });
+
+  /*and add them to the new one: a MATRIX is filled row by row in parallel,
+    the other representations take the whole batch at once */
+  if(rep == MATRIX){
+    parallelRanges(n, parallel, [&](int from, int to){
+      g->fillMatrixRows(edges, start, from, to);
+    });
+  }else{
+    g->addEdges(edges, m, false);
   }
- return g;
+  delete[] edges;
+  delete[] start;
+  return g;
 }
 
 /* free the graph object and all its resources.
 Postcondition: G is no longer a valid pointer. 
 Alert: the caller should set their variable to null.
 */
-Graph::~Graph(){
-  if (type ==MATRIX){
+template <typename W>
+BasicGraph<W>::~BasicGraph(){
+  release();
+}
+
+/* take over the storage of other, leaving it an empty graph */
+template <typename W>
+void BasicGraph<W>::takeFrom(BasicGraph& other){
+  numVertices = other.numVertices; type = other.type; words = other.words;
+  list = other.list; matrix = other.matrix;
+  rowBits = other.rowBits; colBits = other.colBits;
+  chunks = other.chunks; numChunks = other.numChunks; maxChunks = other.maxChunks;
+  chunkFill = other.chunkFill; freeNodes = other.freeNodes;
+  uedges = other.uedges; numUEdges = other.numUEdges; maxUEdges = other.maxUEdges;
+  freeUEdges = other.freeUEdges; uhead = other.uhead; utail = other.utail;
+
+  other.numVertices = other.words = 0;
+  other.type = LIST;
+  other.list = NULL; other.matrix = NULL;
+  other.rowBits = other.colBits = NULL;
+  other.chunks = NULL; other.numChunks = other.maxChunks = other.chunkFill = 0;
+  other.freeNodes = NULL;
+  other.uedges = NULL; other.numUEdges = other.maxUEdges = 0;
+  other.freeUEdges = -1; other.uhead = other.utail = NULL;
+}
+
+/* move constructor, see graph.h */
+template <typename W>
+BasicGraph<W>::BasicGraph(BasicGraph&& other){
+  takeFrom(other);
+}
+
+/* move assignment, see graph.h */
+template <typename W>
+BasicGraph<W>& BasicGraph<W>::operator=(BasicGraph&& other){
+  if(this != &other){
+    release();
+    takeFrom(other);
+  }
+  return *this;
+}
+
+/* free everything the graph owns (the destructor) */
+template <typename W>
+void BasicGraph<W>::release(){
+  if (type == UMATRIX || type == ULIST){
+    delete[] matrix;
+    delete[] rowBits;
+    delete[] uedges;
+    delete[] uhead;
+    delete[] utail;
+    numVertices = type = 0;
+  }else if (type ==MATRIX){
     int i;
 
     //clear out all data
     for(i = 0; i< numVertices * numVertices; i++){
-      matrix[i] = INFINITY;
+      matrix[i] = NONE;
     }
     
     numVertices =type = 0;
     //free(G->v);
     delete[] matrix;
+    delete[] rowBits;
+    delete[] colBits;
   }else {
-    //free all nodes
-    Node* curr;
-    Node* next;
+    //free all nodes, a chunk at a time
     int index;
-    int n = numVertices;
-    for (index=0; index<n; index++){
-      curr = ( list[index]);
-      while(curr!= NULL){
-	next = curr->next;
-	curr->next = NULL; curr->weight = 0; curr->val = 0;
-	delete curr;
-	curr = next;
-      }
+    for (index=0; index<numChunks; index++){
+      delete[] chunks[index];
     }
+    delete[] chunks;
     numVertices = type = 0;
     delete[] list;
   }
 }
 
+/* number of nodes in chunk i of the arena */
+static int chunkSize(int i){
+  return (i >= 10) ? NODE_CHUNK_MAX : NODE_CHUNK_MIN << i;
+}
+
+/* a node from the free list, or else the next unused one in the last chunk
+(starting a new chunk when that one is full) */
+template <typename W>
+typename BasicGraph<W>::Node* BasicGraph<W>::allocNode(){
+  if(freeNodes != NULL){
+    Node* n = freeNodes;
+    freeNodes = n->next;
+    return n;
+  }
+  if(numChunks == 0 || chunkFill == chunkSize(numChunks-1)){
+    if(numChunks == maxChunks){
+      maxChunks = (maxChunks == 0) ? 16 : 2*maxChunks;
+      Node** bigger = new Node*[maxChunks];
+      for(int i = 0; i < numChunks; i++){
+        bigger[i] = chunks[i];
+      }
+      delete[] chunks;
+      chunks = bigger;
+    }
+    chunks[numChunks] = new Node[chunkSize(numChunks)];
+    numChunks++;
+    chunkFill = 0;
+  }
+  return &chunks[numChunks-1][chunkFill++];
+}
+
+/* give a node of a deleted edge back to the arena */
+template <typename W>
+void BasicGraph<W>::releaseNode(Node* n){
+  n->next = freeNodes;
+  freeNodes = n;
+}
+
 /* number of vertices */
-int Graph::numVerts(){
+template <typename W>
+int BasicGraph<W>::numVerts() const{
   return numVertices;
 }
 
+/* MATRIX or LIST */
+template <typename W>
+int BasicGraph<W>::representation() const{
+  return type;
+}
+
 /* add edge from source to target with weight w, and return
 OK, if source and target are valid vertex numbers and
 there was no edge from source to target initially.
 Otherwise, make no change and return ERROR. 
 */
-bool Graph::addEdge(int source, int target, float w){
-  if(source >=numVertices || source <0 ||target >=numVertices || target <0 || w < 0 || w== INFINITY){
+template <typename W>
+bool BasicGraph<W>::addEdge(int source, int target, W w){
+  if(source >=numVertices || source <0 ||target >=numVertices || target <0 || w < 0 || w== NONE){
     return false;
   }
-  if(type==MATRIX){
-    if(matrix[numVertices*source +target] == INFINITY){
+  if(type==UMATRIX){
+    W* cell = &matrix[triangleIndex(source, target)];
+    if(*cell != NONE){
+      return false;
+    }
+    *cell = w;
+    ROWWORD(source, target) |= CELLBIT(target);
+    ROWWORD(target, source) |= CELLBIT(source);
+    return true;
+  }else if(type==ULIST){
+    if(findUEdge(source, target, NULL) != -1){
+      return false;
+    }
+    appendUEdge(source, target, w);
+    return true;
+  }else if(type==MATRIX){
+    if(matrix[numVertices*source +target] == NONE){
       matrix[numVertices*source +target] = w;
+      ROWWORD(source, target) |= CELLBIT(target);
+      COLWORD(source, target) |= CELLBIT(source);
       return true;
     }else {
       return false;
@@ -143,7 +373,7 @@ bool Graph::addEdge(int source, int target, float w){
       prev = curr;
       curr = curr->next;
     }
-    Node* n = new Node();
+    Node* n = allocNode();
     n->next = NULL;
     n->val = target;
     n->weight = w;
@@ -156,17 +386,126 @@ bool Graph::addEdge(int source, int target, float w){
   }
 }
 
+/* add a batch of edges, see graph.h.
+Edge k of the (possibly symmetrized) batch is batch[k] or, when symmetric,
+batch[k/2] forward for even k and reversed for odd k.
+*/
+template <typename W>
+int BasicGraph<W>::addEdges(const Edge* batch, int count, bool symmetric){
+  if(type==ULIST){
+    //an undirected edge is its own reverse
+    return addUEdges(batch, count);
+  }
+  int step = (symmetric && type != UMATRIX) ? 2 : 1;
+  int total = count*step;
+  int added = 0;
+  if(type==MATRIX || type==UMATRIX){
+    //addEdge is already O(1) for a matrix
+    for(int k = 0; k < total; k++){
+      const Edge& e = batch[k/step];
+      bool reversed = (k % step == 1);
+      if(addEdge(reversed ? e.target : e.source, reversed ? e.source : e.target, e.weight)){
+        added++;
+      }
+    }
+    return added;
+  }
+
+  //bucket the valid edges by source (counting sort, so the order within a source is kept)
+  int* start = new int[numVertices+1];
+  for(int v = 0; v <= numVertices; v++){
+    start[v] = 0;
+  }
+  for(int k = 0; k < total; k++){
+    const Edge& e = batch[k/step];
+    int src = (k % step == 1) ? e.target : e.source;
+    int tgt = (k % step == 1) ? e.source : e.target;
+    if(src >=0 && src < numVertices && tgt >= 0 && tgt < numVertices && !(e.weight < 0) && e.weight != NONE){
+      start[src+1]++;
+    }
+  }
+  for(int v = 0; v < numVertices; v++){
+    start[v+1] += start[v];
+  }
+  int* fill = new int[numVertices];
+  for(int v = 0; v < numVertices; v++){
+    fill[v] = start[v];
+  }
+  int* order = new int[start[numVertices]];
+  for(int k = 0; k < total; k++){
+    const Edge& e = batch[k/step];
+    int src = (k % step == 1) ? e.target : e.source;
+    int tgt = (k % step == 1) ? e.source : e.target;
+    if(src >=0 && src < numVertices && tgt >= 0 && tgt < numVertices && !(e.weight < 0) && e.weight != NONE){
+      order[fill[src]++] = k;
+    }
+  }
+
+  //extend each list; seen[t] == src marks that src already has an edge to t
+  int* seen = fill;
+  for(int v = 0; v < numVertices; v++){
+    seen[v] = -1;
+  }
+  for(int src = 0; src < numVertices; src++){
+    if(start[src] == start[src+1]){
+      continue;
+    }
+    Node* tail = NULL;
+    for(Node* curr = list[src]; curr != NULL; curr = curr->next){
+      seen[curr->val] = src;
+      tail = curr;
+    }
+    for(int i = start[src]; i < start[src+1]; i++){
+      const Edge& e = batch[order[i]/step];
+      int tgt = (order[i] % step == 1) ? e.source : e.target;
+      if(seen[tgt] == src){
+        continue;
+      }
+      seen[tgt] = src;
+      Node* n = allocNode();
+      n->next = NULL;
+      n->val = tgt;
+      n->weight = e.weight;
+      if(tail == NULL){
+        list[src] = n;
+      }else{
+        tail->next = n;
+      }
+      tail = n;
+      added++;
+    }
+  }
+  delete[] order;
+  delete[] fill;
+  delete[] start;
+  return added;
+}
+
 /* delete edge from source to target, and return
 OK, if there was an edge from source.
 Otherwise, make no change and return ERROR. 
 */
-bool Graph::delEdge( int source, int target){
+template <typename W>
+bool BasicGraph<W>::delEdge( int source, int target){
   if(source >=numVertices || source <0 ||target >=numVertices || target <0){
     return false;
   }
- if(type==MATRIX){
-    if(matrix[numVertices*source +target] != INFINITY){
-      matrix[numVertices*source +target] = INFINITY;
+ if(type==UMATRIX){
+    W* cell = &matrix[triangleIndex(source, target)];
+    if(*cell == NONE){
+      return false;
+    }
+    *cell = NONE;
+    ROWWORD(source, target) &= ~CELLBIT(target);
+    ROWWORD(target, source) &= ~CELLBIT(source);
+    return true;
+ }else if(type==ULIST){
+    return removeUEdge(source, target);
+ }else if(type==MATRIX){
+    if(matrix[numVertices*source +target] != NONE){
+      matrix[numVertices*source +target] = NONE;
+      ROWWORD(source, target) &= ~CELLBIT(target);
+      COLWORD(source, target) &= ~CELLBIT(source);
       return true;
     }else {
       return false;
@@ -182,8 +521,7 @@ bool Graph::delEdge( int source, int target){
 	}else {
 	  prev->next = curr->next;
 	}
-	curr->val = 0; curr->weight = 0; curr->next = NULL;
-	delete curr;
+	releaseNode(curr);
 	return true;
       }
       prev = curr;
@@ -194,57 +532,195 @@ bool Graph::delEdge( int source, int target){
 }
 
 /* return weight of the edge from source to target,
-if there is one; otherwise return INFINITY.
+if there is one; otherwise return noEdge().
 Return -1 if source or target are out of range.
+The reads go to the representation tags of graphrep.h, so each
+representation is read by one piece of code.
 */
-float Graph::edge(int source, int target){
-  if(source >=numVertices || source <0 ||target >=numVertices || target <0){
+template <typename W>
+W BasicGraph<W>::edge(int source, int target) const{
+  switch(type){
+  case MATRIX: return MatrixRep::edge(*this, source, target);
+  case UMATRIX: return UMatrixRep::edge(*this, source, target);
+  case ULIST: return UListRep::edge(*this, source, target);
+  default: return ListRep::edge(*this, source, target);
+  }
+}
+
+/* put the edges edges[start[v] .. start[v+1]-1] into the rows v of an
+empty MATRIX, for from <= v < to.  Assumes there is at most one edge per
+cell, and that all are valid.  Different threads can fill different rows at
+the same time: rows of the matrix and of rowBits are separate memory, and
+the shared words of colBits are updated atomically. */
+template <typename W>
+void BasicGraph<W>::fillMatrixRows(const Edge* edges, const int* start, int from, int to){
+  for(int v = from; v < to; v++){
+    for(int i = start[v]; i < start[v+1]; i++){
+      int t = edges[i].target;
+      matrix[(size_t)numVertices*v + t] = edges[i].weight;
+      ROWWORD(v, t) |= CELLBIT(t);
+      __atomic_fetch_or(&COLWORD(v, t), CELLBIT(v), __ATOMIC_RELAXED);
+    }
+  }
+}
+
+/* copy the successors of source and the weights of the edges to them into
+targets and weights, and return how many there are (see graph.h) */
+template <typename W>
+int BasicGraph<W>::successorEdges(int source, int* targets, W* weights) const{
+  switch(type){
+  case MATRIX: return MatrixRep::successorEdges(*this, source, targets, weights);
+  case UMATRIX: return UMatrixRep::successorEdges(*this, source, targets, weights);
+  case ULIST: return UListRep::successorEdges(*this, source, targets, weights);
+  default: return ListRep::successorEdges(*this, source, targets, weights);
+  }
+}
+
+/* write the positions of the set bits of bits[0 .. words-1] to out,
+in increasing order, and return how many there were. */
+template <typename W>
+int BasicGraph<W>::scanBits(const uint64_t* bits, int* out) const{
+  int counter = 0;
+  for(int w = 0; w < words; w++){
+    uint64_t word = bits[w];
+    while(word != 0){
+      out[counter++] = w*64 + __builtin_ctzll(word);
+      word &= word - 1; //clear lowest set bit
+    }
+  }
+  return counter;
+}
+
+/* number of set bits in bits[0 .. words-1] */
+template <typename W>
+int BasicGraph<W>::countBits(const uint64_t* bits) const{
+  int counter = 0;
+  for(int w = 0; w < words; w++){
+    counter += __builtin_popcountll(bits[w]);
+  }
+  return counter;
+}
+
+/* number of edges out of source, or -1 if source is invalid */
+template <typename W>
+int BasicGraph<W>::outDegree(int source) const{
+  switch(type){
+  case MATRIX: return MatrixRep::outDegree(*this, source);
+  case UMATRIX: return UMatrixRep::outDegree(*this, source);
+  case ULIST: return UListRep::outDegree(*this, source);
+  default: return ListRep::outDegree(*this, source);
+  }
+}
+
+/* number of edges into target, or -1 if target is invalid */
+template <typename W>
+int BasicGraph<W>::inDegree(int target) const{
+  if(target >=numVertices || target <0){
     return -1;
   }
-   if(type==MATRIX){
-     return matrix[numVertices*source +target];
-   }else /*type is LIST*/ {
-    Node* curr = ( list[source]);
-    Node* prev = NULL;
-   
-    while(curr!=NULL){
+  if(type==UMATRIX || type==ULIST){
+    return outDegree(target);
+  }else if(type==MATRIX){
+    return countBits(colBits + (size_t)target*words);
+  }
+  int counter = 0;
+  for(int i = 0; i<numVertices; i++){
+    for(Node* curr = list[i]; curr != NULL; curr = curr->next){
       if(curr->val == target){
-	return curr->weight;
+	counter++;
       }
-      prev = curr;
-      curr = curr->next;
     }
-    return INFINITY;
   }
+  return counter;
+}
+
+/* see graph.h */
+template <typename W>
+size_t BasicGraph<W>::memoryFootprint() const{
+  size_t bytes = sizeof(*this);
+  size_t n = numVertices;
+  if(type==MATRIX){
+    bytes += n*n*sizeof(W) + 2*n*words*sizeof(uint64_t);
+  }else if(type==UMATRIX){
+    bytes += triangleSize(numVertices)*sizeof(W) + n*words*sizeof(uint64_t);
+  }else if(type==ULIST){
+    bytes += (size_t)maxUEdges*sizeof(UEdge) + 2*n*sizeof(int);
+  }else if(type==LIST){
+    bytes += n*sizeof(Node*) + (size_t)maxChunks*sizeof(Node*);
+    for(int i = 0; i < numChunks; i++){
+      bytes += (size_t)chunkSize(i)*sizeof(Node);
+    }
+  }
+  return bytes;
+}
+
+/* see graph.h; follows the allocations of the constructor, allocNode and
+appendUEdge */
+template <typename W>
+size_t BasicGraph<W>::predictFootprint(int rep, int n, long long edges){
+  if(n < 1){
+    n = 1;
+  }
+  size_t bytes = sizeof(BasicGraph<W>);
+  size_t words = (n + 63) / 64;
+  if(rep==MATRIX){
+    return bytes + (size_t)n*n*sizeof(W) + 2*n*words*sizeof(uint64_t);
+  }else if(rep==UMATRIX){
+    return bytes + (size_t)n*(n+1)/2*sizeof(W) + n*words*sizeof(uint64_t);
+  }else if(rep==ULIST){
+    long long stored = (edges + 1) / 2;
+    long long room = 0;
+    while(room < stored){
+      room = (room == 0) ? 16 : 2*room;
+    }
+    return bytes + (size_t)room*sizeof(UEdge) + 2*(size_t)n*sizeof(int);
+  }else if(rep==LIST){
+    long long nodes = 0;
+    int chunks = 0, room = 0;
+    while(nodes < edges){
+      nodes += chunkSize(chunks);
+      chunks++;
+    }
+    while(room < chunks){
+      room = (room == 0) ? 16 : 2*room;
+    }
+    return bytes + (size_t)n*sizeof(Node*) + (size_t)room*sizeof(Node*) + (size_t)nodes*sizeof(Node);
+  }
+  return 0;
 }
 
 /* a freshly allocated array with the successor
 vertices of source, if any, followed by an entry with -1
 to indicate end of sequence.
 */
-int* Graph::successors( int source){
+template <typename W>
+unique_ptr<int[]> BasicGraph<W>::successors( int source) const{
   if(source >=numVertices || source <0){
     return NULL;
   }
-   if(type==MATRIX){
+   if(type==UMATRIX){
+     int counter = outDegree(source);
+     int* s = new int[counter+1];//space for -1
+     scanBits(rowBits + (size_t)source*words, s);
+     s[counter] = -1; //-1 terminating array
+     return unique_ptr<int[]>(s);
+   }else if(type==ULIST){
+     int counter = outDegree(source);
+     int* s = new int[counter+1];//space for -1
+     int i = 0;
+     for(int e = uhead[source]; e != -1; e = uedges[e].next[uside(e, source)]){
+       s[i++] = uedges[e].end[1 - uside(e, source)];
+     }
+     s[counter] = -1;
+     return unique_ptr<int[]>(s);
+   }else if(type==MATRIX){
 
      //figure out how big array will need to be
-     int i;
-     int counter=0;
-     for(i=0; i<numVertices; i++){
-       if(matrix[numVertices*source+i]!= INFINITY){
-	 counter++;
-       }
-     }
+     int counter = outDegree(source);
      int* s = new int[counter+1];//space for -1
-      for(i=0; i<numVertices; i++){
-	if(matrix[numVertices*source+i]!= INFINITY){
-	  *s = i;
-	  s++;
-	}
-      }
-      *s = -1; //-1 terminating array
-      return s-counter; //put our pointer back to the begining
+     scanBits(rowBits + (size_t)source*words, s);
+     s[counter] = -1; //-1 terminating array
+     return unique_ptr<int[]>(s);
    }else /*type is LIST*/ {
      int i;
      int counter=0;
@@ -263,7 +739,7 @@ int* Graph::successors( int source){
      }
      *s = -1;
       
-     return s-counter; 
+     return unique_ptr<int[]>(s-counter);
    }
 }
 
@@ -271,27 +747,20 @@ int* Graph::successors( int source){
 vertices of target, if any, followed by an entry with -1
 to indicate end of sequence.
 */
-int* Graph::predecessors( int target){
+template <typename W>
+unique_ptr<int[]> BasicGraph<W>::predecessors( int target) const{
   if(target >=numVertices || target <0){
     return NULL;
   }
-  if(type==MATRIX){
-    int i;
-    int counter=0;
-    for(i=0; i<numVertices; i++){
-      if(matrix[numVertices*i+target]!= INFINITY){
-	counter ++;
-      }
-    }
+  if(type==UMATRIX || type==ULIST){
+    //every edge goes both ways
+    return successors(target);
+  }else if(type==MATRIX){
+    int counter = inDegree(target);
     int* s = new int[counter+1];//space for -1
-    for(i=0; i<numVertices; i++){
-      if(matrix[numVertices*i+target]!= INFINITY){
-	*s = i;
-	s++;
-      }
-    }
-    *s = -1; //-1 terminating array
-    return s-counter;
+    scanBits(colBits + (size_t)target*words, s);
+    s[counter] = -1; //-1 terminating array
+    return unique_ptr<int[]>(s);
   }else{
     int i;
     int counter=0;
@@ -316,6 +785,167 @@ int* Graph::predecessors( int target){
       }
     }
     *s = -1;
-    return s-counter; 
+    return unique_ptr<int[]>(s-counter);
+  }
+}
+
+
+/* UNDIRECTED REPRESENTATIONS */
+
+/* cells in the upper triangle (with the diagonal) of an n by n matrix */
+template <typename W>
+size_t BasicGraph<W>::triangleSize(int n) const{
+  return (size_t)n*(n+1)/2;
+}
+
+/* which end of ULIST edge e is v: 0 or 1 (0 for a self loop) */
+template <typename W>
+int BasicGraph<W>::uside(int e, int v) const{
+  return (uedges[e].end[0] == v) ? 0 : 1;
+}
+
+/* index of the ULIST edge between s and t, or -1 if none.
+If prev is not NULL it gets the edge before it on the list of s (-1 if it is first). */
+template <typename W>
+int BasicGraph<W>::findUEdge(int s, int t, int* prev) const{
+  int before = -1;
+  for(int e = uhead[s]; e != -1; e = uedges[e].next[uside(e, s)]){
+    if(uedges[e].end[1 - uside(e, s)] == t){
+      if(prev != NULL){
+        *prev = before;
+      }
+      return e;
+    }
+    before = e;
   }
+  return -1;
 }
+
+/* add a new ULIST edge s-t with weight w at the end of both adjacency lists,
+assuming it is not there yet */
+template <typename W>
+void BasicGraph<W>::appendUEdge(int s, int t, W w){
+  int e;
+  if(freeUEdges != -1){
+    e = freeUEdges;
+    freeUEdges = uedges[e].next[0];
+  }else{
+    if(numUEdges == maxUEdges){
+      maxUEdges = (maxUEdges == 0) ? 16 : 2*maxUEdges;
+      UEdge* bigger = new UEdge[maxUEdges];
+      for(int i = 0; i < numUEdges; i++){
+        bigger[i] = uedges[i];
+      }
+      delete[] uedges;
+      uedges = bigger;
+    }
+    e = numUEdges++;
+  }
+  uedges[e].end[0] = s;
+  uedges[e].end[1] = t;
+  uedges[e].weight = w;
+  uedges[e].next[0] = uedges[e].next[1] = -1;
+  int ends = (s == t) ? 1 : 2;
+  for(int k = 0; k < ends; k++){
+    int v = uedges[e].end[k];
+    if(utail[v] == -1){
+      uhead[v] = e;
+    }else{
+      uedges[utail[v]].next[uside(utail[v], v)] = e;
+    }
+    utail[v] = e;
+  }
+}
+
+/* delete the ULIST edge s-t from both adjacency lists, see delEdge */
+template <typename W>
+bool BasicGraph<W>::removeUEdge(int s, int t){
+  int prev[2];
+  int e = findUEdge(s, t, &prev[0]);
+  if(e == -1){
+    return false;
+  }
+  findUEdge(t, s, &prev[1]);
+  int ends = (s == t) ? 1 : 2;
+  int v[2] = {s, t};
+  for(int k = 0; k < ends; k++){
+    int after = uedges[e].next[uside(e, v[k])];
+    if(prev[k] == -1){
+      uhead[v[k]] = after;
+    }else{
+      uedges[prev[k]].next[uside(prev[k], v[k])] = after;
+    }
+    if(utail[v[k]] == e){
+      utail[v[k]] = prev[k];
+    }
+  }
+  uedges[e].next[0] = freeUEdges;
+  freeUEdges = e;
+  return true;
+}
+
+/* addEdges for ULIST: bucket the edges by their smaller end, and use a mark
+array to find duplicates, so the batch costs O(V + E) */
+template <typename W>
+int BasicGraph<W>::addUEdges(const Edge* batch, int count){
+  int* start = new int[numVertices+1];
+  for(int v = 0; v <= numVertices; v++){
+    start[v] = 0;
+  }
+  for(int k = 0; k < count; k++){
+    const Edge& e = batch[k];
+    if(e.source >=0 && e.source < numVertices && e.target >= 0 && e.target < numVertices && !(e.weight < 0) && e.weight != NONE){
+      start[(e.source < e.target ? e.source : e.target)+1]++;
+    }
+  }
+  for(int v = 0; v < numVertices; v++){
+    start[v+1] += start[v];
+  }
+  int* seen = new int[numVertices];
+  for(int v = 0; v < numVertices; v++){
+    seen[v] = start[v];
+  }
+  int* order = new int[start[numVertices]];
+  for(int k = 0; k < count; k++){
+    const Edge& e = batch[k];
+    if(e.source >=0 && e.source < numVertices && e.target >= 0 && e.target < numVertices && !(e.weight < 0) && e.weight != NONE){
+      order[seen[(e.source < e.target ? e.source : e.target)]++] = k;
+    }
+  }
+
+  //seen[t] == s marks that s already has an edge to t
+  for(int v = 0; v < numVertices; v++){
+    seen[v] = -1;
+  }
+  int added = 0;
+  for(int s = 0; s < numVertices; s++){
+    if(start[s] == start[s+1]){
+      continue;
+    }
+    for(int e = uhead[s]; e != -1; e = uedges[e].next[uside(e, s)]){
+      seen[uedges[e].end[1 - uside(e, s)]] = s;
+    }
+    for(int i = start[s]; i < start[s+1]; i++){
+      const Edge& e = batch[order[i]];
+      int t = (e.source == s) ? e.target : e.source;
+      if(seen[t] == s){
+        continue;
+      }
+      seen[t] = s;
+      appendUEdge(s, t, e.weight);
+      added++;
+    }
+  }
+  delete[] order;
+  delete[] seen;
+  delete[] start;
+  return added;
+}
+
+
+/* the weight types the graph is compiled for, see graph.h */
+template class BasicGraph<float>;
+template class BasicGraph<double>;
+template class BasicGraph<uint16_t>;
+template class BasicGraph<uint32_t>;
+template class BasicGraph<int64_t>;
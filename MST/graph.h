@@ -2,6 +2,9 @@
 #define	GRAPH_H	
 
 #include <math.h>
+#include <stdint.h>
+#include <limits>
+#include <memory>
 
 /* Simple interface for weighted directed graphs.
 
@@ -12,15 +15,61 @@
    Function cloneGraph() can be used to convert between 
    representations.
 
+   There are also two undirected representations, which store each edge
+   once and show it in both directions: addEdge(s,t,w) also makes t->s, 
+   edge(t,s) == edge(s,t), delEdge removes both directions, and
+   successors(v) == predecessors(v) lists every neighbor of v.  UMATRIX packs
+   the upper triangle of the matrix, and ULIST keeps each edge in one array
+   entry threaded onto the adjacency lists of both ends.  They take about half
+   the memory of a symmetric MATRIX or LIST, which is what minSpanTree wants.
+
+   The functions that only read the graph are const, and any number of
+   threads may call them on the same graph at once, as long as no thread
+   is changing it.  For reading while another thread writes, see
+   VersionedGraph in snapshot.h.
+
+   The weight type W is a template parameter; Graph is the usual float
+   graph.  BasicGraph is instantiated (in graph.cpp) for float, double,
+   uint16_t, uint32_t and int64_t.  A uint16_t MATRIX takes half the memory 
+   of a float one.
 */
 
 #define MATRIX 0
 #define LIST 1
+#define UMATRIX 2 /* undirected, packed upper triangular matrix */
+#define ULIST 3   /* undirected, each edge stored once */
 
 
 using namespace std;
 
-class Graph{
+
+/* The special weight values for a weight type W.
+   noEdge() is what edge() returns when there is no edge, and it can
+   never be the weight of an edge: INFINITY for float and double, the
+   largest value of the type for integer types (65535 for uint16_t).
+   badVertex() is what edge() returns for an invalid vertex number: -1, 
+   except for unsigned types, which cannot hold -1 and return noEdge().
+*/
+template <typename W>
+struct WeightTraits {
+  static W noEdge() {
+    return numeric_limits<W>::has_infinity ? numeric_limits<W>::infinity()
+                                           : numeric_limits<W>::max();
+  }
+  static W badVertex() {
+    return numeric_limits<W>::is_signed ? (W)-1 : noEdge();
+  }
+};
+
+
+/* the representation tags of graphrep.h, which read BasicGraph directly */
+struct MatrixRep;
+struct ListRep;
+struct UMatrixRep;
+struct UListRep;
+
+template <typename W>
+class BasicGraph{
 
  public:
 
@@ -28,34 +77,67 @@ class Graph{
 
   
   
-/* Make an empty graph with n vertices (empty means all edges either set to INFINITY or NULL,
+  typedef W weight_type;
+
+  /* an edge source -> target with weight weight, for addEdges */
+  struct Edge {
+    int source;
+    int target;
+    W weight;
+  };
+
+/* Make an empty graph with n vertices (empty means all edges either set to noEdge() or NULL,
    depending on representation), using either adjacency matrix 
-   or adjacency lists depending on whether rep==MATRIX or rep==LIST.
+   or adjacency lists depending on whether rep==MATRIX or rep==LIST
+   (or the undirected UMATRIX or ULIST).
    if n <1, return NULL
    if rep is not MATRIX or LIST, return NULL
 */
-Graph(int n, int rep);
+BasicGraph(int n, int rep);
 
 
  /* free the graph object and ALL its resources. 
 */
-~Graph();
+~BasicGraph();
+
+
+/* Graphs can be moved but not copied (use cloneGraph for a deep copy).
+   Moving takes over the other graph's storage in O(1); the moved-from
+   graph is left empty (0 vertices) and may only be destroyed or assigned to.
+*/
+BasicGraph(BasicGraph&& other);
+BasicGraph& operator=(BasicGraph&& other);
+BasicGraph(const BasicGraph&) = delete;
+BasicGraph& operator=(const BasicGraph&) = delete;
 
 
 /* make a DEEP copy of g, but using the representation
    specified by rep (which is assumed to be MATRIX or LIST) 
    Everything should be copied over, not just references
    I.E. a change in the first graph should not change the second graph
-   If rep is not MATRIX or LIST, return NULL
+   If rep is not MATRIX or LIST (or UMATRIX or ULIST), return NULL
+
+   Takes time proportional to V plus the number of edges, not V*V: the
+   adjacency is read out with successorEdges and put in with addEdges.  On
+   big graphs (CLONE_PARALLEL_MIN edges or more, see graph.cpp) both the
+   read out and, for a MATRIX copy, the fill are split over the hardware
+   threads by source vertex; the degrees are counted first, on one thread.
+   Copying a directed graph into UMATRIX or ULIST keeps, for each pair of
+   vertices u < v, the edge u->v if there is one and v->u otherwise (the
+   edges are added in increasing order of source).
 */
-Graph* cloneGraph(int rep);
+unique_ptr<BasicGraph> cloneGraph(int rep) const;
 
 
 
 
 /* return number of vertices.
  Note that this is needed since the property numVerts is private*/
-int numVerts();
+int numVerts() const;
+
+
+/* return the representation of the graph, MATRIX, LIST, UMATRIX or ULIST. */
+int representation() const;
 
 
 /* add edge from source to target with weight w, and return
@@ -63,9 +145,24 @@ int numVerts();
    there was no edge from source to target initially.
    Otherwise if source or target are invalid, or the edge already exists,
     make no change and return false. If the edge already exists, DO NOT UPDATE IT! Just return false
-    if w is INFINITY or negative, do nothing, and return false.
+    if w is noEdge() or negative, do nothing, and return false.
+*/
+bool addEdge( int source, int target, W w);
+
+
+/* add a batch of count edges, with the same result as calling addEdge on
+   each of them in order: invalid edges are skipped, and when the batch (or
+   the graph) has several edges from the same source to the same target,
+   the first one wins.
+   If symmetric is true, each edge S->T of the batch is followed by T->S
+   with the same weight, as readGraphMakeSymm does.
+   Return the number of edges added.
+
+   For LIST the batch is bucketed by source and each list is extended in
+   one pass, so this takes O(V + E) time, where addEdge has to walk the
+   whole list for every edge.  The new nodes of each list are contiguous.
 */
-bool addEdge( int source, int target, float w);
+int addEdges(const Edge* batch, int count, bool symmetric);
 
 
 /* delete edge from source to target, and return
@@ -76,10 +173,10 @@ bool delEdge( int source, int target);
 
 
 /* return weight of the edge from source to target,
-   if there is one; otherwise return INFINITY. (part of the math.h library)
-   Return -1.0 if source or target are not valid vertex numbers.
+   if there is one; otherwise return noEdge() (INFINITY for float).
+   Return badVertex() (-1.0 for float) if source or target are not valid vertex numbers.
 */
-float edge( int source, int target);
+W edge( int source, int target) const;
 
 
 /* return a freshly new'd array with the successor
@@ -89,10 +186,9 @@ float edge( int source, int target);
    If there are no successors, the array should only contain a -1
    If source is not a valid vertex number, return NULL
 
-   Ownersip: the caller is responsible for deleting the array in their file.
-   You should not make any delete call in your file graph relating to successors, but rather in your test file
+   Ownership: the array is returned in a unique_ptr, which deletes it.
 */
-int* successors( int source);
+unique_ptr<int[]> successors( int source) const;
 
 /*  return a freshly new'd array with the predecessor
    vertices of source, if any, followed by an entry with -1
@@ -101,20 +197,102 @@ int* successors( int source);
    If there are no successors, the array should only contain a -1
    If source is not a valid vertex number, return NULL
 
-   Ownersip: the caller is responsible for deleting the array in their file.
-   You should not make any delete call in your file relating to successors
+   Ownership: the array is returned in a unique_ptr, which deletes it.
 */
-int* predecessors( int target);
+unique_ptr<int[]> predecessors( int target) const;
+
+
+/* copy the successors of source into targets, and the weight of the edge
+   to each of them into weights at the same position, in the same order as
+   successors(source), and return how many there are.
+   targets and weights must have room for outDegree(source) entries.
+   Unlike successors() this allocates nothing, so it is meant for loops.
+   If source is not a valid vertex number, return -1.
+*/
+int successorEdges( int source, int* targets, W* weights) const;
+
+
+/* return the number of successors of source (the length of the array
+   successors(source) would return, without the -1), or -1 if source is
+   not a valid vertex number.
+   For MATRIX this is a popcount over the occupancy bitmap of the row.
+*/
+int outDegree( int source) const;
+
+
+/* return the number of predecessors of target, or -1 if target is not
+   a valid vertex number.
+   For MATRIX this is a popcount over the occupancy bitmap of the column;
+   for LIST it has to look at every edge of the graph.
+*/
+int inDegree( int target) const;
+
+
+/* return the number of bytes of memory the graph holds: the object itself
+   and every array it has allocated, including the room not used yet at the
+   end of the LIST arena and of the ULIST edge array.
+*/
+size_t memoryFootprint() const;
+
+
+/* return what memoryFootprint() would be for a new graph of representation
+   rep with n vertices, after addEdges has put in edges edges, counted as
+   outDegree counts them (so an undirected edge of a UMATRIX or ULIST counts
+   twice, for both directions).  This lets a loader pick the representation
+   before building the graph.  0 if rep is not a representation.
+*/
+static size_t predictFootprint(int rep, int n, long long edges);
 
  
  private:
   int numVertices; //numer of vertices the graph has
   int type; //the representation of the graph, list or matrix
   Node** list; //a pointer to the array used for the adjacency list, if used
-  float* matrix; //a pointer to the matrix, if used
+  W* matrix; //a pointer to the matrix, if used
+  uint64_t* rowBits; //MATRIX only: bit set for each cell with an edge, row by row
+  uint64_t* colBits; //MATRIX only: the same bits, column by column
+  int words; //number of 64 bit words per row/column of rowBits/colBits
+  //UMATRIX uses matrix (the packed upper triangle) and rowBits; colBits is NULL
+
+  struct UEdge; //an edge of a ULIST graph, see graph.cpp
+  UEdge* uedges; //ULIST only: all edges, each once
+  int numUEdges; //number of entries of uedges in use (including freed ones)
+  int maxUEdges; //length of uedges
+  int freeUEdges; //deleted edges, linked through next[0], or -1
+  int* uhead; //ULIST only: first edge on the list of each vertex, or -1
+  int* utail; //ULIST only: last edge on the list of each vertex, or -1
+
+  size_t triangleSize(int n) const;
+  size_t triangleIndex(int s, int t) const;
+  int uside(int e, int v) const;
+  int findUEdge(int s, int t, int* prev) const;
+  void appendUEdge(int s, int t, W w);
+  bool removeUEdge(int s, int t);
+  int addUEdges(const Edge* batch, int count);
+
+  Node** chunks; //LIST only: the arena the Nodes are taken from (see graph.cpp)
+  int numChunks; //number of chunks allocated
+  int maxChunks; //length of the chunks array
+  int chunkFill; //number of nodes handed out from the last chunk
+  Node* freeNodes; //nodes of deleted edges, linked through next, for reuse
+
+  void takeFrom(BasicGraph& other);
+  void release();
+  Node* allocNode();
+  void releaseNode(Node* n);
+  void fillMatrixRows(const Edge* edges, const int* start, int from, int to);
+  int scanBits(const uint64_t* bits, int* out) const;
+  int countBits(const uint64_t* bits) const;
 
   //note that at any point in time, only list or matrix will be used; the other will be null 
+
+  friend struct MatrixRep;
+  friend struct ListRep;
+  friend struct UMatrixRep;
+  friend struct UListRep;
 };
+
+typedef BasicGraph<float> Graph;
   
 
 #endif
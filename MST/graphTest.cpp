@@ -0,0 +1,436 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+#include "graph.h"
+#include "graphio.h"
+#include "compressed.h"
+#include "builder.h"
+#include "snapshot.h"
+#include "primmst.h"
+
+/*
+ * Checks the ways of storing and moving graphs against a plain BasicGraph,
+ * for every weight type: GraphWriter's three formats, written out and read
+ * back; CompressedGraph with exact and quantized weights; GraphBuilder
+ * filled from several threads; and VersionedGraph's snapshots.
+ *
+ * testAllFiles.sh builds and runs it; prints one line per failure and
+ * "Graph Checks: PASSED" or "Graph Checks: FAILED".
+ */
+
+
+/* a weight for a W, nonnegative and below noEdge(): for the real types
+ with awkward decimals (halves at the sixth decimal, 2^32 and beyond,
+ tiny ones), for the integer types up to the top of the range */
+template <typename W>
+static W randomWeight(){
+    static const double awkward[] = {0, 0.5, 0.0000005, 0.0000015, 0.1234565, 123.4565,
+                                     4294967295.9999996, 4294967296.25, 1e12 + 0.125, 2.5e-7,
+                                     999999.9999995, 7.75};
+    if(!numeric_limits<W>::is_integer){
+        if(rand() % 3 == 0){
+            return (W)awkward[rand() % (int)(sizeof(awkward) / sizeof(awkward[0]))];
+        }
+        return (W)(rand() / (double)RAND_MAX * 1000.0);
+    }
+    double top = (double)WeightTraits<W>::noEdge() - 1;
+    if(top > 1e15){
+        top = 1e15;  //readGraph goes through a double
+    }
+    if(rand() % 4 == 0){
+        return (W)top;
+    }
+    return (W)(rand() / (double)RAND_MAX * top);
+}
+
+
+/* a graph of n vertices named "0", "1", ... in representation rep, with
+ about 3n random edges (both ways for LIST and MATRIX) */
+template <typename W>
+static basicgraphinfo<W> randomInfo(int n, int rep, unsigned int seed){
+    srand(seed);
+    basicgraphinfo<W> gi;
+    gi.graph.reset(new BasicGraph<W>(n, rep));
+    for(int v = 0; v < n; v++){
+        gi.vertnames.push_back(std::to_string(v));
+    }
+    for(int k = 0; k < 3 * n; k++){
+        int u = rand() % n, v = rand() % n;
+        W w = randomWeight<W>();
+        gi.graph->addEdge(u, v, w);
+        if(rep == LIST || rep == MATRIX){
+            gi.graph->addEdge(v, u, w);
+        }
+    }
+    return gi;
+}
+
+
+/* w as it comes back from text: printed with "%f" and read as a double */
+template <typename W>
+static W throughText(W w){
+    char text[400];
+    snprintf(text, sizeof(text), "%f", (double)w);
+    return (W)strtod(text, NULL);
+}
+
+
+/* true if h (a BasicGraph, or any graph with edge and outDegree) has
+ exactly the edges of g, with the weights passed through text when text is
+ set */
+template <typename W, class G>
+static bool sameEdges(const BasicGraph<W>* g, const G* h, bool text){
+    int n = g->numVerts();
+    if(h->numVerts() != n){
+        return false;
+    }
+    std::vector<int> targets(n);
+    std::vector<W> weights(n);
+    long long edges = 0;
+    for(int v = 0; v < n; v++){
+        int degree = g->successorEdges(v, targets.data(), weights.data());
+        edges += degree;
+        for(int i = 0; i < degree; i++){
+            W w = text ? throughText(weights[i]) : weights[i];
+            if(h->edge(v, targets[i]) != w){
+                return false;
+            }
+        }
+    }
+    for(int v = 0; v < n; v++){
+        edges -= h->outDegree(v);
+    }
+    return edges == 0;
+}
+
+
+/* write gi to a new temporary file in format, with text first if not NULL;
+ return its name, or "" if that failed */
+template <typename W>
+static std::string writeTemp(const basicgraphinfo<W>& gi, int format, const char* text){
+    char name[] = "/tmp/graphTestXXXXXX";
+    int fd = mkstemp(name);
+    if(fd < 0){
+        return "";
+    }
+    bool ok = (text == NULL) || write(fd, text, strlen(text)) == (ssize_t)strlen(text);
+    {
+        GraphWriter writer(fd, 4096);  //small, so the buffer fills and flushes often
+        ok = writer.write(gi, format) && writer.flush() && ok;
+    }
+    close(fd);
+    if(!ok){
+        unlink(name);
+        return "";
+    }
+    return name;
+}
+
+
+/* GraphWriter in each format, read back: GRAPH_TEXT with readGraph,
+ GRAPH_EDGELIST with readGraph after a header naming the vertices by
+ number, GRAPH_BINARY field by field */
+template <typename W>
+static bool checkWriter(const char* type, unsigned int seed){
+    static const int reps[] = {LIST, ULIST, MATRIX, UMATRIX};
+    bool ok = true;
+    for(int r = 0; r < 4; r++){
+        int n = 200 + 50 * r;
+        basicgraphinfo<W> gi = randomInfo<W>(n, reps[r], seed + r);
+
+        std::string path = writeTemp(gi, GRAPH_TEXT, NULL);
+        basicgraphinfo<W> back = readGraph<W>((char*)path.c_str(), reps[r]);
+        if(path.empty() || back.vertnames != gi.vertnames || !sameEdges(gi.graph.get(), back.graph.get(), true)){
+            printf("GraphWriter GRAPH_TEXT, %s, representation %d: read back differs\n", type, reps[r]);
+            ok = false;
+        }
+        unlink(path.c_str());
+
+        std::string header = std::to_string(n) + "\n";
+        for(int v = 0; v < n; v++){
+            header += gi.vertnames[v] + "\n";
+        }
+        path = writeTemp(gi, GRAPH_EDGELIST, header.c_str());
+        back = readGraph<W>((char*)path.c_str(), reps[r]);
+        if(path.empty() || !sameEdges(gi.graph.get(), back.graph.get(), true)){
+            printf("GraphWriter GRAPH_EDGELIST, %s, representation %d: read back differs\n", type, reps[r]);
+            ok = false;
+        }
+        unlink(path.c_str());
+
+        //binary: the header, then the edges, each once for an undirected graph
+        path = writeTemp(gi, GRAPH_BINARY, NULL);
+        FILE* file = fopen(path.c_str(), "rb");
+        int32_t fields[3] = {0, 0, 0};
+        int64_t count = -1;
+        bool good = file != NULL && fread(fields, sizeof(fields), 1, file) == 1
+                    && fread(&count, sizeof(count), 1, file) == 1
+                    && fields[0] == GRAPH_BINARY_MAGIC && fields[1] == n && fields[2] == (int32_t)sizeof(W);
+        unique_ptr<BasicGraph<W> > built(new BasicGraph<W>(n, reps[r]));
+        for(int64_t k = 0; good && k < count; k++){
+            int32_t ends[2];
+            W w;
+            good = fread(ends, sizeof(ends), 1, file) == 1 && fread(&w, sizeof(w), 1, file) == 1;
+            if(good && !built->addEdge(ends[0], ends[1], w)){
+                good = false;  //an edge twice, or out of range
+            }
+        }
+        good = good && fgetc(file) == EOF && sameEdges(gi.graph.get(), built.get(), false);
+        if(file != NULL){
+            fclose(file);
+        }
+        if(!good){
+            printf("GraphWriter GRAPH_BINARY, %s, representation %d: read back differs\n", type, reps[r]);
+            ok = false;
+        }
+        unlink(path.c_str());
+    }
+    return ok;
+}
+
+
+/* the weights of the edges of an undirected tree, each edge once, sorted:
+ the same for every minimum spanning tree of a graph */
+template <typename W>
+static std::vector<W> treeWeights(const BasicGraph<W>* tree){
+    int n = tree->numVerts();
+    std::vector<int> targets(n);
+    std::vector<W> weights(n), all;
+    for(int v = 0; v < n; v++){
+        int degree = tree->successorEdges(v, targets.data(), weights.data());
+        for(int i = 0; i < degree; i++){
+            if(v <= targets[i]){
+                all.push_back(weights[i]);
+            }
+        }
+    }
+    std::sort(all.begin(), all.end());
+    return all;
+}
+
+
+/* CompressedGraph with exact, 16 and 8 bit weights against the graph it
+ was made from: the same targets, in increasing order; weights exact, or
+ within half a quantization step; edge() agreeing with successorEdges();
+ the batch constructor giving the same graph; and minSpanTree on it
+ agreeing with minSpanTree on a BasicGraph of the decoded weights */
+template <typename W>
+static bool checkCompressed(const char* type, unsigned int seed){
+    static const int reps[] = {LIST, ULIST, MATRIX, UMATRIX};
+    static const int widths[] = {0, 16, 8};
+    bool ok = true;
+    for(int r = 0; r < 4; r++){
+        int n = 150 + 40 * r;
+        basicgraphinfo<W> gi = randomInfo<W>(n, reps[r], seed + r);
+        const BasicGraph<W>* g = gi.graph.get();
+
+        std::vector<int> targets(n), ct(n), bt(n);
+        std::vector<W> weights(n), cw(n), bw(n);
+        std::vector<typename BasicGraph<W>::Edge> batch;
+        double low = 0, high = 0;
+        for(int v = 0; v < n; v++){
+            int degree = g->successorEdges(v, targets.data(), weights.data());
+            for(int i = 0; i < degree; i++){
+                typename BasicGraph<W>::Edge e = {v, targets[i], weights[i]};
+                batch.push_back(e);
+                if(batch.size() == 1 || (double)weights[i] < low) low = (double)weights[i];
+                if(batch.size() == 1 || (double)weights[i] > high) high = (double)weights[i];
+            }
+        }
+
+        for(int b = 0; b < 3; b++){
+            int bits = widths[b];
+            //how far a decoded weight may be from the original
+            double tolerance = 0;
+            if(bits != 0){
+                double levels = (double)((1 << bits) - 1);
+                if(!numeric_limits<W>::is_integer){
+                    tolerance = (high - low) / levels / 2 + 1e-6 * high;
+                }else if(high - low > levels){
+                    tolerance = (high - low) / levels / 2 + 0.5;
+                }
+            }
+            CompressedGraph<W> c(g, bits);
+            CompressedGraph<W> fromBatch(n, batch.data(), (int)batch.size(), false, bits);
+            unique_ptr<BasicGraph<W> > decoded(new BasicGraph<W>(n, LIST));
+            bool good = c.numVerts() == n && c.numEdges() == (long long)batch.size()
+                        && c.representation() == COMPRESSED;
+            for(int v = 0; good && v < n; v++){
+                int degree = g->outDegree(v);
+                good = c.successorEdges(v, ct.data(), cw.data()) == degree && c.outDegree(v) == degree
+                       && fromBatch.successorEdges(v, bt.data(), bw.data()) == degree;
+                for(int i = 0; good && i < degree; i++){
+                    W original = g->edge(v, ct[i]);
+                    good = (i == 0 || ct[i - 1] < ct[i]) && original != WeightTraits<W>::noEdge()
+                           && (bits == 0 ? cw[i] == original
+                                         : fabs((double)cw[i] - (double)original) <= tolerance)
+                           && c.edge(v, ct[i]) == cw[i] && bt[i] == ct[i] && bw[i] == cw[i];
+                    decoded->addEdge(v, ct[i], cw[i]);
+                }
+            }
+            if(!good){
+                printf("CompressedGraph, %s, representation %d, %d bits: differs from the graph\n",
+                       type, reps[r], bits);
+                ok = false;
+            }else if(treeWeights(minSpanTree(&c).get()) != treeWeights(minSpanTree(decoded.get()).get())){
+                printf("CompressedGraph, %s, representation %d, %d bits: minSpanTree differs\n",
+                       type, reps[r], bits);
+                ok = false;
+            }
+        }
+    }
+    return ok;
+}
+
+
+/* GraphBuilder with 1 to 4 threads, each adding a share of a batch of
+ edges, against the same batch given to addEdges: freeze in every
+ representation, both ways and not, twice to check the buffers can be
+ filled again, then freezeCompressed.  The batch has invalid edges and
+ repeats; a repeated edge, either way round, always has the same weight,
+ since which thread's copy wins is not specified. */
+template <typename W>
+static bool checkBuilder(const char* type, unsigned int seed){
+    static const int reps[] = {LIST, ULIST, MATRIX, UMATRIX};
+    srand(seed);
+    int n = 300;
+    std::vector<typename BasicGraph<W>::Edge> batch;
+    for(int k = 0; k < 6 * n; k++){
+        typename BasicGraph<W>::Edge e = {rand() % (n + 4) - 2, rand() % n, 0};
+        //the weight depends on the ends only, in either order
+        srand(seed + std::min(e.source, e.target) * n + std::max(e.source, e.target));
+        e.weight = randomWeight<W>();
+        srand(seed + k + 1);
+        if(k % 50 == 0){
+            e.weight = WeightTraits<W>::noEdge();
+        }
+        batch.push_back(e);
+    }
+
+    bool ok = true;
+    for(int threads = 1; threads <= 4; threads++){
+        for(int r = 0; r < 4; r++){
+            for(int symmetric = 0; symmetric < 2; symmetric++){
+                unique_ptr<BasicGraph<W> > expected(new BasicGraph<W>(n, reps[r]));
+                expected->addEdges(batch.data(), (int)batch.size(), symmetric);
+                unique_ptr<BasicGraph<W> > listed(new BasicGraph<W>(n, LIST));
+                listed->addEdges(batch.data(), (int)batch.size(), symmetric);
+                GraphBuilder<W> builder(n);
+                for(int round = 0; round < 3; round++){
+                    std::vector<std::thread> workers;
+                    for(int t = 0; t < threads; t++){
+                        workers.push_back(std::thread([&builder, &batch, t, threads](){
+                            typename GraphBuilder<W>::Buffer* mine = builder.buffer();
+                            for(size_t k = t; k < batch.size(); k += threads){
+                                mine->add(batch[k].source, batch[k].target, batch[k].weight);
+                            }
+                        }));
+                    }
+                    for(int t = 0; t < threads; t++){
+                        workers[t].join();
+                    }
+                    bool good;
+                    if(round < 2){
+                        good = sameEdges(expected.get(), builder.freeze(reps[r], symmetric).get(), false);
+                    }else{
+                        good = sameEdges(listed.get(), builder.freezeCompressed(symmetric, 0).get(), false);
+                    }
+                    if(!good){
+                        printf("GraphBuilder, %s, %d threads, representation %d%s, %s: differs from addEdges\n",
+                               type, threads, reps[r], symmetric ? " both ways" : "",
+                               round < 2 ? "freeze" : "freezeCompressed");
+                        ok = false;
+                    }
+                }
+            }
+        }
+    }
+    return ok;
+}
+
+
+/* VersionedGraph in each representation through rounds of random addEdge,
+ delEdge and addEdges, each followed by publish, against a BasicGraph given
+ the same changes.  In each round: the snapshot taken before keeps the
+ graph it had (so the first change copied the published graph); nothing
+ shows until publish; after publish every change of the round is there (so
+ the later changes did not copy the published graph again) and the version
+ is one more; and a publish with no changes does nothing. */
+template <typename W>
+static bool checkSnapshots(const char* type, unsigned int seed){
+    static const int reps[] = {LIST, ULIST, MATRIX, UMATRIX};
+    bool ok = true;
+    for(int r = 0; r < 4; r++){
+        int n = 60 + 10 * r;
+        basicgraphinfo<W> gi = randomInfo<W>(n, reps[r], seed + r);
+        unique_ptr<BasicGraph<W> > expected = gi.graph->cloneGraph(reps[r]);
+        VersionedGraph<W> versioned(std::move(*gi.graph));
+        bool good = true;
+        for(int round = 1; good && round <= 6; round++){
+            typename VersionedGraph<W>::Snapshot before = versioned.snapshot();
+            unique_ptr<BasicGraph<W> > old = expected->cloneGraph(reps[r]);
+            int changes = 1 + rand() % 20;
+            for(int k = 0; good && k < changes; k++){
+                int u = rand() % n, v = rand() % n;
+                W w = randomWeight<W>();
+                if(k % 3 == 1){
+                    good = versioned.delEdge(u, v) == expected->delEdge(u, v);
+                }else if(k % 3 == 2){
+                    typename BasicGraph<W>::Edge e = {u, v, w};
+                    good = versioned.addEdges(&e, 1, true) == expected->addEdges(&e, 1, true);
+                }else{
+                    good = versioned.addEdge(u, v, w) == expected->addEdge(u, v, w);
+                }
+                typename VersionedGraph<W>::Snapshot now = versioned.snapshot();
+                good = good && now.graph == before.graph && now.version == before.version
+                       && sameEdges(old.get(), before.graph.get(), false);
+            }
+            unsigned long long version = versioned.publish();
+            typename VersionedGraph<W>::Snapshot after = versioned.snapshot();
+            good = good && version == before.version + 1 && after.version == version
+                   && versioned.version() == version && after.graph != before.graph
+                   && sameEdges(expected.get(), after.graph.get(), false)
+                   && sameEdges(old.get(), before.graph.get(), false);
+            good = good && versioned.publish() == version && versioned.snapshot().graph == after.graph;
+        }
+        if(!good){
+            printf("VersionedGraph, %s, representation %d: snapshots differ from the changes made\n",
+                   type, reps[r]);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+
+int main(int argc, char* argv[]){
+    bool ok = checkWriter<float>("float", 100);
+    ok = checkWriter<double>("double", 200) && ok;
+    ok = checkWriter<uint16_t>("uint16_t", 300) && ok;
+    ok = checkWriter<uint32_t>("uint32_t", 400) && ok;
+    ok = checkWriter<int64_t>("int64_t", 500) && ok;
+    ok = checkCompressed<float>("float", 600) && ok;
+    ok = checkCompressed<double>("double", 700) && ok;
+    ok = checkCompressed<uint16_t>("uint16_t", 800) && ok;
+    ok = checkCompressed<uint32_t>("uint32_t", 900) && ok;
+    ok = checkCompressed<int64_t>("int64_t", 1000) && ok;
+    ok = checkBuilder<float>("float", 1100) && ok;
+    ok = checkBuilder<double>("double", 1200) && ok;
+    ok = checkBuilder<uint16_t>("uint16_t", 1300) && ok;
+    ok = checkBuilder<uint32_t>("uint32_t", 1400) && ok;
+    ok = checkBuilder<int64_t>("int64_t", 1500) && ok;
+    ok = checkSnapshots<float>("float", 1600) && ok;
+    ok = checkSnapshots<double>("double", 1700) && ok;
+    ok = checkSnapshots<uint16_t>("uint16_t", 1800) && ok;
+    ok = checkSnapshots<uint32_t>("uint32_t", 1900) && ok;
+    ok = checkSnapshots<int64_t>("int64_t", 2000) && ok;
+    printf("Graph Checks: %s\n", ok ? "PASSED" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -2,6 +2,10 @@
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#include <math.h>
+#include <errno.h>
+#include <unistd.h>
+#include <unordered_map>
 #include "graphio.h"
 
 /* IMPLEMENTATION OF graphio.h*/
@@ -12,10 +16,11 @@
 
 
 /* see graphio.h */
-int vertexNum(GraphInfo gi, char* name) {
+template <typename W>
+int vertexNum(const basicgraphinfo<W>& gi, const char* name) {
     int i = 0;
-    int n = gi->graph->numVerts();
-    while ( i < n && strcmp(gi->vertnames[i], name) )
+    int n = (int) gi.vertnames.size();
+    while ( i < n && gi.vertnames[i] != name )
         i++;
     if (i < n)
         return i;
@@ -25,13 +30,30 @@ int vertexNum(GraphInfo gi, char* name) {
 
 
 
+/* Convert a weight read from the file to W, rounding for integer types.
+ Return false if it does not fit in W (see graphio.h). */
+template <typename W>
+bool toWeight(double weight, W* w) {
+    if (!numeric_limits<W>::is_integer) {
+        *w = (W) weight;
+        return true;
+    }
+    double rounded = round(weight); /* check what is stored, so noEdge() itself is refused */
+    if (rounded < 0 || !(rounded < (double) WeightTraits<W>::noEdge()))
+        return false;
+    *w = (W) rounded;
+    return true;
+}
+
+
 /* Read a graph from a text file, using the requested representation.
  Assumes filepath is a null-terminated string that is valid file path.
  Assumes the file exists and has the format specified in graphio.h.
  If makeSymmetric is MAKE_SYMM, add both (S,T) and (T,S) for each edge S T in the file
  (except when (T,S) present from an earlier line of the file).
  */
-GraphInfo readGraphX(char* filepath, int repType, int makeSymmetric) {
+template <typename W>
+basicgraphinfo<W> readGraphX(char* filepath, int repType, int makeSymmetric) {
     
     /* open file, initialize input buffer, get number of vertices */
     FILE* file = fopen(filepath, "r");
@@ -45,19 +67,15 @@ GraphInfo readGraphX(char* filepath, int repType, int makeSymmetric) {
     int numVerts;
     sscanf(line, "%i", &numVerts); /* parse the line */
     
-    /* allocate and initialize GraphInfo */
-    GraphInfo gi = (GraphInfo) malloc(sizeof(struct graphinfo));
-    gi->graph = new Graph(numVerts, repType);
-    char **vertnames = (char**) malloc(numVerts * sizeof(char *));
-    gi->vertnames = vertnames;
+    /* initialize GraphInfo; the graph is made once the edges are read */
+    basicgraphinfo<W> gi;
     
     /* get vertex names */
     char source[MAX_NAMELEN + 1];
     int i = 0;
     while( i < numVerts && getline(&line, &lineSize, file) > 0 ) {
         sscanf(line, "%s", source);
-        vertnames[i] = (char *) malloc(strlen(source) + 1);
-        strcpy(vertnames[i], source);
+        gi.vertnames.push_back(source);
         i++;
     }
     if (i != numVerts) {
@@ -65,27 +83,55 @@ GraphInfo readGraphX(char* filepath, int repType, int makeSymmetric) {
         exit(1);
     }
     
-    /* get the edges */
+    /* look the edge ends up by name in a hash map, not with vertexNum's
+       linear search; the first vertex of a name wins, as in vertexNum */
+    unordered_map<string, int> number;
+    number.reserve(numVerts);
+    for (int v = 0; v < numVerts; v++)
+        number.emplace(gi.vertnames[v], v);
+
+    /* get the edges, and add them to the graph in one batch at the end */
     char target[MAX_NAMELEN + 1];
-    float weight;
+    double weight;
+    int numEdges = 0;
+    int maxEdges = 16;
+    typename BasicGraph<W>::Edge* edges = (typename BasicGraph<W>::Edge*) malloc(maxEdges * sizeof(*edges));
     
     while ( getline(&line, &lineSize, file) > 0 ) {
-        int result = sscanf(line, "%s %s %f\n", source, target, &weight);
+        int result = sscanf(line, "%s %s %lf\n", source, target, &weight);
         
         if (result >= 2 ) { // read at least two items
-            int src = vertexNum(gi, source);
-            int trg = vertexNum(gi, target);
+            unordered_map<string, int>::const_iterator found = number.find(source);
+            int src = (found == number.end()) ? -1 : found->second;
+            found = number.find(target);
+            int trg = (found == number.end()) ? -1 : found->second;
             if (result == 2) // weight not included
                 weight = DEFAULT_WEIGHT;
-            (gi->graph)->addEdge(src, trg, weight);
-            if (makeSymmetric)
-	      (gi->graph)->addEdge( trg, src, weight);
+            W w;
+            if (!toWeight(weight, &w)) {
+                fprintf(stderr, "graphio:readGraph - weight %f out of range (ignored) in %s\n", weight, filepath);
+                continue;
+            }
+            if (numEdges == maxEdges) {
+                maxEdges *= 2;
+                edges = (typename BasicGraph<W>::Edge*) realloc(edges, maxEdges * sizeof(*edges));
+            }
+            edges[numEdges].source = src;
+            edges[numEdges].target = trg;
+            edges[numEdges].weight = w;
+            numEdges++;
         } else
             if (result == 1)
                 fprintf(stderr, "graphio:readGraph - file format error (ignored) getting edges in %s\n", filepath);
     }
     
+    if (repType == AUTOREP)
+        repType = chooseRepresentation<W>(numVerts, numEdges, makeSymmetric);
+    gi.graph.reset(new BasicGraph<W>(numVerts, repType));
+    (gi.graph)->addEdges(edges, numEdges, makeSymmetric);
+    
     /* clean up and return */
+    free(edges);
     free(line);
     fclose(file);
     
@@ -94,47 +140,235 @@ GraphInfo readGraphX(char* filepath, int repType, int makeSymmetric) {
 
 
 /* see graphio.h */
-GraphInfo readGraph(char* filepath, int repType) {
-    return readGraphX(filepath, repType, 0);
+template <typename W>
+int chooseRepresentation(int n, long long lines, bool symmetric) {
+    int dense = symmetric ? UMATRIX : MATRIX;
+    int sparse = symmetric ? ULIST : LIST;
+    long long edges = symmetric ? 2 * lines : lines;
+    if (BasicGraph<W>::predictFootprint(dense, n, edges) < BasicGraph<W>::predictFootprint(sparse, n, edges))
+        return dense;
+    else
+        return sparse;
 }
 
 
 /* see graphio.h */
-GraphInfo readGraphMakeSymm(char* filepath, int repType) {
-    return readGraphX(filepath, repType, 1);
+template <typename W>
+basicgraphinfo<W> readGraph(char* filepath, int repType) {
+    return readGraphX<W>(filepath, repType, 0);
 }
 
 
 /* see graphio.h */
-void writeGraph(GraphInfo gi) {
-  int numV = gi->graph->numVerts();
-  printf("%i \n", numV);
-  for (int v = 0; v < numV; v++)
-    printf("%s \n", gi->vertnames[v]);
-  for (int v = 0; v < numV; v++) {
-    int* succs = gi->graph->successors( v);
-    int i = 0;
-    if (succs[0] != -1) 
-      printf("\n");
-    while (succs[i] != -1) {
-      printf("%s %s %f \n", gi->vertnames[v], gi->vertnames[succs[i]], gi->graph->edge(v, succs[i]));
-      i++;
+template <typename W>
+basicgraphinfo<W> readGraphMakeSymm(char* filepath, int repType) {
+    return readGraphX<W>(filepath, repType, 1);
+}
+
+
+/* see graphio.h */
+template <typename W>
+void writeGraph(const basicgraphinfo<W>& gi) {
+    fflush(stdout); /* whatever was printf'd before goes first */
+    GraphWriter out(STDOUT_FILENO);
+    out.write(gi, GRAPH_TEXT);
+}
+
+
+/* see graphio.h */
+GraphWriter::GraphWriter(int fd, int bufsize) {
+    this->fd = fd;
+    size = (bufsize < 4096 ? 4096 : bufsize);
+    buffer = (char*) malloc(size);
+    used = 0;
+    failed = false;
+}
+
+
+/* see graphio.h */
+GraphWriter::~GraphWriter() {
+    flush();
+    free(buffer);
+}
+
+
+/* see graphio.h */
+bool GraphWriter::flush() {
+    int done = 0;
+    while (done < used && !failed) {
+        ssize_t n = ::write(fd, buffer + done, used - done);
+        if (n < 0 && errno != EINTR)
+            failed = true;
+        else if (n > 0)
+            done += n;
     }
-  }
-  printf("\n");
-  
-    
+    used = 0;
+    return !failed;
+}
+
+
+/* append len bytes of s to the buffer, flushing as it fills */
+void GraphWriter::put(const char* s, int len) {
+    while (len > 0) {
+        if (used == size)
+            flush();
+        int n = (len < size - used ? len : size - used);
+        memcpy(buffer + used, s, n);
+        used += n;
+        s += n;
+        len -= n;
+    }
+}
+
+void GraphWriter::putString(const char* s) {
+    put(s, strlen(s));
+}
+
+void GraphWriter::putBytes(const void* p, int len) {
+    put((const char*) p, len);
+}
+
+/* append i in decimal */
+void GraphWriter::putInt(long long i) {
+    char digits[24];
+    int n = sizeof(digits);
+    unsigned long long u = (i < 0 ? -(unsigned long long) i : i);
+    do {
+        digits[--n] = '0' + u % 10;
+        u /= 10;
+    } while (u > 0);
+    if (i < 0)
+        digits[--n] = '-';
+    put(digits + n, sizeof(digits) - n);
+}
+
+/* append w as printf("%f") would: integer part, '.', six rounded decimals.
+ * The fraction is exact for w below 2^32: w - floor(w) is exact and
+ * multiplying it by 10^6 is off by far less than 10^-6, so the rounding can
+ * only go wrong right at a half, which is left to snprintf, as are big,
+ * negative and non-finite values. */
+void GraphWriter::putWeight(double w) {
+    if (w >= 0 && w < 4294967296.0) {
+        unsigned long long whole = (unsigned long long) w;
+        double scaled = (w - (double) whole) * 1e6;
+        double micros = floor(scaled);
+        double rest = scaled - micros;
+        if (fabs(rest - 0.5) > 1e-6) {
+            unsigned long long frac = (unsigned long long) micros + (rest > 0.5 ? 1 : 0);
+            if (frac == 1000000) {
+                whole++;
+                frac = 0;
+            }
+            putInt(whole);
+            char decimals[7];
+            decimals[0] = '.';
+            for (int d = 6; d >= 1; d--) {
+                decimals[d] = '0' + frac % 10;
+                frac /= 10;
+            }
+            put(decimals, 7);
+            return;
+        }
+    }
+    char text[400];
+    put(text, snprintf(text, sizeof(text), "%f", w));
 }
 
 
 /* see graphio.h */
-void disposeGraphInfo(GraphInfo gi) {
-    for (int i = 0; i < gi->graph->numVerts(); i++)
-        free(gi->vertnames[i]);
-    free(gi->vertnames);    
-    delete (gi->graph); //note this calls the graph destructor
-    free(gi);
+template <typename W>
+bool GraphWriter::write(const basicgraphinfo<W>& gi, int format) {
+    if (format != GRAPH_TEXT && format != GRAPH_EDGELIST && format != GRAPH_BINARY)
+        return false;
+    BasicGraph<W>* g = gi.graph.get();
+    int numV = g->numVerts();
+    bool undirected = (g->representation() == UMATRIX || g->representation() == ULIST);
+    bool bothWays = (format == GRAPH_TEXT || !undirected);
+
+    /* buffers for successorEdges, big enough for any vertex */
+    int maxDegree = 0;
+    long long numEdges = 0;
+    for (int v = 0; v < numV; v++) {
+        int d = g->outDegree(v);
+        if (d > maxDegree)
+            maxDegree = d;
+        numEdges += d;
+    }
+    int* targets = new int[maxDegree + 1];
+    W* weights = new W[maxDegree + 1];
+
+    if (format == GRAPH_TEXT) {
+        putInt(numV);
+        putString(" \n");
+        for (int v = 0; v < numV; v++) {
+            putString(gi.vertnames[v].c_str());
+            putString(" \n");
+        }
+    } else if (format == GRAPH_BINARY) {
+        if (!bothWays) {
+            /* count each edge once: loops once, others twice */
+            numEdges = 0;
+            for (int v = 0; v < numV; v++) {
+                int d = g->successorEdges(v, targets, weights);
+                for (int i = 0; i < d; i++)
+                    if (v <= targets[i])
+                        numEdges++;
+            }
+        }
+        int32_t header[3] = { GRAPH_BINARY_MAGIC, numV, (int32_t) sizeof(W) };
+        int64_t edgeCount = numEdges; /* may pass 2^31 */
+        putBytes(header, sizeof(header));
+        putBytes(&edgeCount, sizeof(edgeCount));
+    }
+
+    for (int v = 0; v < numV; v++) {
+        int d = g->successorEdges(v, targets, weights);
+        if (format == GRAPH_TEXT && d > 0)
+            putString("\n");
+        for (int i = 0; i < d; i++) {
+            if (!bothWays && targets[i] < v)
+                continue;
+            if (format == GRAPH_TEXT) {
+                put(gi.vertnames[v].data(), gi.vertnames[v].size());
+                put(" ", 1);
+                put(gi.vertnames[targets[i]].data(), gi.vertnames[targets[i]].size());
+                put(" ", 1);
+                putWeight((double) weights[i]);
+                putString(" \n");
+            } else if (format == GRAPH_EDGELIST) {
+                putInt(v);
+                put(" ", 1);
+                putInt(targets[i]);
+                put(" ", 1);
+                putWeight((double) weights[i]);
+                put("\n", 1);
+            } else {
+                int32_t ends[2] = { v, targets[i] };
+                putBytes(ends, sizeof(ends));
+                putBytes(&weights[i], sizeof(W));
+            }
+        }
+    }
+    if (format == GRAPH_TEXT)
+        putString("\n");
+
+    delete[] targets;
+    delete[] weights;
+    return !failed;
 }
 
 
+/* the weight types graphio is compiled for, same as BasicGraph in graph.cpp */
+#define GRAPHIO_INSTANTIATE(W) \
+    template int vertexNum<W>(const basicgraphinfo<W>&, const char*); \
+    template basicgraphinfo<W> readGraph<W>(char*, int); \
+    template basicgraphinfo<W> readGraphMakeSymm<W>(char*, int); \
+    template int chooseRepresentation<W>(int, long long, bool); \
+    template void writeGraph<W>(const basicgraphinfo<W>&); \
+    template bool GraphWriter::write<W>(const basicgraphinfo<W>&, int);
 
+GRAPHIO_INSTANTIATE(float)
+GRAPHIO_INSTANTIATE(double)
+GRAPHIO_INSTANTIATE(uint16_t)
+GRAPHIO_INSTANTIATE(uint32_t)
+GRAPHIO_INSTANTIATE(int64_t)
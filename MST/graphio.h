@@ -2,6 +2,9 @@
 #define GRAPHIO_H
  
 #include "graph.h"
+#include <memory>
+#include <string>
+#include <vector>
 
 /****************************************************************
 Graphs with names for vertices.
@@ -22,59 +25,146 @@ The W is optional; if omitted, the weight is interpreted as DEFAULT_WEIGHT.
 
 /* change history:
  * DN 4/18/2016 writeGraph write weights 
- * DN 2/16/2017 add disposeGraphInfo, improve comments */
+ * DN 2/16/2017 add disposeGraphInfo, improve comments
+ * templated on the weight type W, like BasicGraph (see graph.h); GraphInfo
+ * is still the float version, and the functions default to float
+ * GraphInfo owns its graph and names and is returned by value, so
+ * disposeGraphInfo is gone */
 
 
 #define DEFAULT_WEIGHT 1.0 
 #define MAX_NAMELEN 32 /* max length of a vertex name */
+#define AUTOREP -1 /* repType for readGraph: pick the representation, see below */
 
 /* A graph together with names for its vertices. 
-   The vertnames field should point to an array of string pointers.
-   The length of that array should be numVerts(graph).
+   The length of vertnames should be numVerts(graph).
+   A graphinfo owns both: they are freed when it goes away.  It can be
+   moved (cheaply, nothing is copied) but not copied.
 */
-struct graphinfo {
-    Graph* graph;
-    char **vertnames; 
+template <typename W>
+struct basicgraphinfo {
+    unique_ptr<BasicGraph<W> > graph;
+    vector<string> vertnames; 
 };
-typedef struct graphinfo* GraphInfo;
+typedef basicgraphinfo<float> GraphInfo;
 
 
 /* Index of a given vertex name, or -1 if not found. */
-/* NOTE: To get the name for a given vertex number v, just use g->vertnames[v] */
-int vertexNum(GraphInfo gi, char* name);
+/* NOTE: To get the name for a given vertex number v, just use gi.vertnames[v] */
+template <typename W>
+int vertexNum(const basicgraphinfo<W>& gi, const char* name);
 
 
 /* Read a graph from a text file, assuming format described above. 
  * Assumes filepath is a null-terminated string that is valid file path.
  * Assumes the file has the format specified above.
  *
- * Ownership: the caller is responsible for disposing of the graph, for
- * freeing the vertnames, and for freeing the graphinfo object itself.
- * See disposeGraphInfo.
+ * Ownership: the result owns the graph and the names (see basicgraphinfo).
+ *
+ * The weights are read as decimals and converted to W; for an integer W
+ * they are rounded, and a weight that does not fit once rounded (negative,
+ * or not below WeightTraits<W>::noEdge()) is reported and its line ignored.
+ * Example: readGraph<uint16_t>(path, MATRIX).
+ *
+ * With repType AUTOREP the edges are read first, and the graph is made in
+ * the representation chooseRepresentation gives for that many vertices
+ * and edges; see gi.graph->representation() for which one it was.
  */
-GraphInfo readGraph(char* filepath, int repType);
+template <typename W = float>
+basicgraphinfo<W> readGraph(char* filepath, int repType);
 
 
 /* Same as readGraph, but make a symmetric graph by also adding T->S
  * in addition to S->T, for a line with S T, unless there was already
  * an edge T->S from a preceding line of the file.
+ * (For the undirected UMATRIX and ULIST every graph is symmetric, so this
+ * is the same as readGraph; each edge is stored once.)
+ * AUTOREP works as for readGraph.
+ */
+template <typename W = float>
+basicgraphinfo<W> readGraphMakeSymm(char* filepath, int repType);
+
+
+/* The representation with the smallest memoryFootprint (see graph.h) for
+ * n vertices and a file of lines edge lines: MATRIX or LIST, or for a
+ * symmetric graph the undirected UMATRIX or ULIST, which take about half
+ * the memory.  Each edge is assumed distinct.  The smaller one is also the
+ * one minSpanTree is quicker on: a matrix only wins when the graph is dense,
+ * which is when computeMST (dispatch.h) runs its queue-free Prim's on it.
  */
-GraphInfo readGraphMakeSymm(char* filepath, int repType);
+template <typename W = float>
+int chooseRepresentation(int n, long long lines, bool symmetric);
 
 
 /* Prints the graph to stdout (the terminal), in the file format:
- * Assumes gi points to a valid object.  
+ * Assumes gi has a graph.  
  * Output should be IDENTICAL to the input file, except that it
  * prints weights even if they are the default weight, and blank lines in the 
  * input file don't need to be in the output text
+ * (This is a GraphWriter on standard out with format GRAPH_TEXT.)
  */
-void writeGraph(GraphInfo gi);
-
-
-/* Free the graph, the vertex names, the array of those,
- * and the GraphioInfo itself. 
+template <typename W>
+void writeGraph(const basicgraphinfo<W>& gi);
+
+
+/* Output formats of GraphWriter */
+#define GRAPH_TEXT 0      /* the file format above, as writeGraph prints it */
+#define GRAPH_EDGELIST 1  /* one "u v w" line per edge, u and v vertex numbers */
+#define GRAPH_BINARY 2    /* a header of three int32: GRAPH_BINARY_MAGIC,
+                             numVerts and sizeof(W), and the number of edges
+                             as an int64; then for each edge int32 u, int32 v
+                             and the W weight, all in the byte order of the
+                             machine.  No vertex names. */
+#define GRAPH_BINARY_MAGIC 0x54534d50 /* "PMST" read as a little endian int */
+
+/* Writes graphs to a file descriptor, fast.
+ * Output is formatted into a buffer owned by the writer, and the buffer is
+ * handed to write(2) whenever it fills up, so a big graph costs one system
+ * call per bufsize bytes instead of a printf per edge.  Weights are printed
+ * like printf's "%f" but without going through printf.  The adjacency is
+ * read with successorEdges, so nothing is allocated per vertex.
+ *
+ * The writer can be kept and used for several graphs; the buffer is reused.
+ * Undirected graphs (UMATRIX, ULIST) are written with every edge in both
+ * directions in GRAPH_TEXT, as readGraph expects, but only once (u <= v)
+ * in the other formats.
+ *
+ * The writer does not own fd; it does not close it.
  */
-void disposeGraphInfo(GraphInfo gi);
+class GraphWriter {
+
+ public:
+
+  /* a writer to fd with a buffer of bufsize bytes (at least 4096) */
+  GraphWriter(int fd, int bufsize = 1 << 20);
+
+  /* flushes, then frees the buffer */
+  ~GraphWriter();
+
+  /* format gi in the given format (GRAPH_TEXT, GRAPH_EDGELIST or 
+   * GRAPH_BINARY) into the buffer, writing out the full parts.
+   * Return false if the format is unknown or a write failed.  The end of
+   * the output may still be in the buffer; see flush.
+   */
+  template <typename W>
+  bool write(const basicgraphinfo<W>& gi, int format);
+
+  /* write out whatever is in the buffer; false if the write failed */
+  bool flush();
+
+ private:
+  void put(const char* s, int len);
+  void putString(const char* s);
+  void putInt(long long i);
+  void putWeight(double w);
+  void putBytes(const void* p, int len);
+
+  int fd;         //where to write
+  char* buffer;   //the output not written yet
+  int size;       //size of buffer
+  int used;       //bytes of buffer in use
+  bool failed;    //a write has failed
+};
 
 
 #endif 
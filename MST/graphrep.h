@@ -0,0 +1,340 @@
+#ifndef GRAPHREP_H
+#define GRAPHREP_H
+
+#include "graph.h"
+
+/* Graphs whose representation is known at compile time.
+
+   Every read of a BasicGraph (edge, successorEdges, outDegree) first checks
+   which of the four representations it has.  The check is cheap, but it
+   sits in the inner loops of Prim's and keeps the compiler from inlining
+   the loop over the adjacency into the caller.
+
+   Here each representation gets a tag type, MatrixRep, ListRep, UMatrixRep
+   and UListRep, whose static functions read a BasicGraph of that
+   representation directly, with no check of the type.  Two graph types are
+   built on the tags:
+
+     RepGraph<Rep, W>  owns a BasicGraph<W> of representation Rep.
+     RepView<Rep, W>   refers to a BasicGraph<W> someone else owns, which
+                       must have representation Rep.
+
+   The storage is the BasicGraph's (graph.cpp), so nothing is duplicated;
+   adding and deleting edges goes through the BasicGraph as before.
+   BasicGraph itself stays as the type-erased graph, for code that picks
+   the representation at run time: its edge, successorEdges and outDegree
+   switch on the representation and call the tag, so each representation
+   is read by the code here and nowhere else.
+
+   THE GRAPH CONCEPT
+   BasicGraph<W>, RepGraph<Rep, W> and RepView<Rep, W> all have
+
+     typedef ... weight_type;                          W
+     int numVerts() const;
+     int representation() const;                       MATRIX, LIST, ...
+     W edge(int source, int target) const;             as in graph.h
+     int successorEdges(int source, int* targets, W* weights) const;
+     int outDegree(int source) const;
+
+   with the meanings of graph.h, and that is all minSpanTree and PrimSolver
+   (primmst.h) use, so they are templates on the graph type.  Given a
+   BasicGraph, minSpanTree looks at representation() once and runs on the
+   matching RepView.
+*/
+
+
+/* A BasicGraph's layout, shared by graph.cpp and the tags below */
+
+template <typename W>
+struct BasicGraph<W>::Node {
+  int val;
+  W weight;
+  Node* next;
+};
+
+/* an edge of a ULIST graph, stored once: the edge end[0]-end[1] is on the
+   adjacency list of both ends, and next[k] is the edge after it on the list
+   of end[k] (-1 at the end).  A self loop is only on the list once, through
+   next[0].  Edges live in one array and refer to each other by index. */
+template <typename W>
+struct BasicGraph<W>::UEdge {
+  int end[2];
+  W weight;
+  int next[2];
+};
+
+/* position of cell (s,t), or equally (t,s), in the packed upper triangle of
+   a UMATRIX: row i holds the cells (i,i) .. (i,n-1) and starts after the
+   n + (n-1) + ... cells of the rows above it.  Here rather than in
+   graph.cpp so that the UMatrixRep reads inline it. */
+template <typename W>
+inline size_t BasicGraph<W>::triangleIndex(int s, int t) const{
+  if(s > t){
+    int tmp = s; s = t; t = tmp;
+  }
+  return (size_t)s*numVertices - (size_t)s*(s-1)/2 + (t - s);
+}
+
+
+/* THE TAGS
+   Each has id, the representation constant, and edge, successorEdges and
+   outDegree taking the graph as first argument, same results as graph.h. */
+
+struct MatrixRep {
+  enum { id = MATRIX };
+
+  template <typename W>
+  static W edge(const BasicGraph<W>& g, int source, int target){
+    if(source >= g.numVertices || source < 0 || target >= g.numVertices || target < 0){
+      return WeightTraits<W>::badVertex();
+    }
+    return g.matrix[(size_t)g.numVertices*source + target];
+  }
+
+  template <typename W>
+  static int successorEdges(const BasicGraph<W>& g, int source, int* targets, W* weights){
+    if(source >= g.numVertices || source < 0){
+      return -1;
+    }
+    const uint64_t* bits = g.rowBits + (size_t)source*g.words;
+    const W* row = g.matrix + (size_t)g.numVertices*source;
+    int counter = 0;
+    for(int w = 0; w < g.words; w++){
+      for(uint64_t word = bits[w]; word != 0; word &= word - 1){
+        int t = w*64 + __builtin_ctzll(word);
+        targets[counter] = t;
+        weights[counter] = row[t];
+        counter++;
+      }
+    }
+    return counter;
+  }
+
+  template <typename W>
+  static int outDegree(const BasicGraph<W>& g, int source){
+    if(source >= g.numVertices || source < 0){
+      return -1;
+    }
+    const uint64_t* bits = g.rowBits + (size_t)source*g.words;
+    int counter = 0;
+    for(int w = 0; w < g.words; w++){
+      counter += __builtin_popcountll(bits[w]);
+    }
+    return counter;
+  }
+};
+
+
+struct ListRep {
+  enum { id = LIST };
+
+  template <typename W>
+  static W edge(const BasicGraph<W>& g, int source, int target){
+    if(source >= g.numVertices || source < 0 || target >= g.numVertices || target < 0){
+      return WeightTraits<W>::badVertex();
+    }
+    for(typename BasicGraph<W>::Node* curr = g.list[source]; curr != NULL; curr = curr->next){
+      if(curr->val == target){
+        return curr->weight;
+      }
+    }
+    return WeightTraits<W>::noEdge();
+  }
+
+  template <typename W>
+  static int successorEdges(const BasicGraph<W>& g, int source, int* targets, W* weights){
+    if(source >= g.numVertices || source < 0){
+      return -1;
+    }
+    int counter = 0;
+    for(typename BasicGraph<W>::Node* curr = g.list[source]; curr != NULL; curr = curr->next){
+      targets[counter] = curr->val;
+      weights[counter] = curr->weight;
+      counter++;
+    }
+    return counter;
+  }
+
+  template <typename W>
+  static int outDegree(const BasicGraph<W>& g, int source){
+    if(source >= g.numVertices || source < 0){
+      return -1;
+    }
+    int counter = 0;
+    for(typename BasicGraph<W>::Node* curr = g.list[source]; curr != NULL; curr = curr->next){
+      counter++;
+    }
+    return counter;
+  }
+};
+
+
+struct UMatrixRep {
+  enum { id = UMATRIX };
+
+  template <typename W>
+  static W edge(const BasicGraph<W>& g, int source, int target){
+    if(source >= g.numVertices || source < 0 || target >= g.numVertices || target < 0){
+      return WeightTraits<W>::badVertex();
+    }
+    return g.matrix[g.triangleIndex(source, target)];
+  }
+
+  template <typename W>
+  static int successorEdges(const BasicGraph<W>& g, int source, int* targets, W* weights){
+    if(source >= g.numVertices || source < 0){
+      return -1;
+    }
+    const uint64_t* bits = g.rowBits + (size_t)source*g.words;
+    int counter = 0;
+    for(int w = 0; w < g.words; w++){
+      for(uint64_t word = bits[w]; word != 0; word &= word - 1){
+        int t = w*64 + __builtin_ctzll(word);
+        targets[counter] = t;
+        weights[counter] = g.matrix[g.triangleIndex(source, t)];
+        counter++;
+      }
+    }
+    return counter;
+  }
+
+  template <typename W>
+  static int outDegree(const BasicGraph<W>& g, int source){
+    return MatrixRep::outDegree(g, source);  //same row bitmaps
+  }
+};
+
+
+struct UListRep {
+  enum { id = ULIST };
+
+  template <typename W>
+  static W edge(const BasicGraph<W>& g, int source, int target){
+    if(source >= g.numVertices || source < 0 || target >= g.numVertices || target < 0){
+      return WeightTraits<W>::badVertex();
+    }
+    for(int e = g.uhead[source]; e != -1; ){
+      const typename BasicGraph<W>::UEdge& u = g.uedges[e];
+      int side = (u.end[0] == source) ? 0 : 1;
+      if(u.end[1 - side] == target){
+        return u.weight;
+      }
+      e = u.next[side];
+    }
+    return WeightTraits<W>::noEdge();
+  }
+
+  template <typename W>
+  static int successorEdges(const BasicGraph<W>& g, int source, int* targets, W* weights){
+    if(source >= g.numVertices || source < 0){
+      return -1;
+    }
+    int counter = 0;
+    for(int e = g.uhead[source]; e != -1; ){
+      const typename BasicGraph<W>::UEdge& u = g.uedges[e];
+      int side = (u.end[0] == source) ? 0 : 1;
+      targets[counter] = u.end[1 - side];
+      weights[counter] = u.weight;
+      counter++;
+      e = u.next[side];
+    }
+    return counter;
+  }
+
+  template <typename W>
+  static int outDegree(const BasicGraph<W>& g, int source){
+    if(source >= g.numVertices || source < 0){
+      return -1;
+    }
+    int counter = 0;
+    for(int e = g.uhead[source]; e != -1; ){
+      const typename BasicGraph<W>::UEdge& u = g.uedges[e];
+      e = u.next[(u.end[0] == source) ? 0 : 1];
+      counter++;
+    }
+    return counter;
+  }
+};
+
+
+/* A BasicGraph<W> owned by someone else, known to have representation Rep. */
+template <class Rep, typename W = float>
+class RepView {
+
+ public:
+  typedef W weight_type;
+
+  /* g must have representation Rep::id and outlive the view */
+  explicit RepView(const BasicGraph<W>& g) : graph(&g) {}
+
+  int numVerts() const { return graph->numVerts(); }
+  int representation() const { return Rep::id; }
+  W edge(int source, int target) const { return Rep::edge(*graph, source, target); }
+  int successorEdges(int source, int* targets, W* weights) const {
+    return Rep::successorEdges(*graph, source, targets, weights);
+  }
+  int outDegree(int source) const { return Rep::outDegree(*graph, source); }
+
+  /* the graph looked at */
+  const BasicGraph<W>& erased() const { return *graph; }
+
+ private:
+  const BasicGraph<W>* graph;
+};
+
+
+/* A graph of representation Rep, with the interface of BasicGraph.
+   Reads go straight to the representation; edges are added and deleted
+   through the BasicGraph inside, which erased() gives for code written for
+   the type-erased graph. */
+template <class Rep, typename W = float>
+class RepGraph {
+
+ public:
+  typedef W weight_type;
+  typedef typename BasicGraph<W>::Edge Edge;
+
+  /* an empty graph of n vertices, see BasicGraph(n, rep) */
+  explicit RepGraph(int n) : graph(n, Rep::id) {}
+
+  /* take over g, converting it with cloneGraph if its representation is not Rep */
+  explicit RepGraph(BasicGraph<W>&& g) : graph(std::move(g)) {
+    if(graph.representation() != Rep::id){
+      graph = std::move(*graph.cloneGraph(Rep::id));
+    }
+  }
+
+  RepGraph(RepGraph&& other) = default;
+  RepGraph& operator=(RepGraph&& other) = default;
+
+  int numVerts() const { return graph.numVerts(); }
+  int representation() const { return Rep::id; }
+  W edge(int source, int target) const { return Rep::edge(graph, source, target); }
+  int successorEdges(int source, int* targets, W* weights) const {
+    return Rep::successorEdges(graph, source, targets, weights);
+  }
+  int outDegree(int source) const { return Rep::outDegree(graph, source); }
+
+  bool addEdge(int source, int target, W w) { return graph.addEdge(source, target, w); }
+  int addEdges(const Edge* batch, int count, bool symmetric){
+    return graph.addEdges(batch, count, symmetric);
+  }
+  bool delEdge(int source, int target) { return graph.delEdge(source, target); }
+  unique_ptr<int[]> successors(int source) const { return graph.successors(source); }
+  unique_ptr<int[]> predecessors(int target) const { return graph.predecessors(target); }
+  int inDegree(int target) const { return graph.inDegree(target); }
+
+  /* the BasicGraph inside, with the same edges */
+  BasicGraph<W>& erased() { return graph; }
+  const BasicGraph<W>& erased() const { return graph; }
+
+ private:
+  BasicGraph<W> graph;
+};
+
+typedef RepGraph<MatrixRep> MatrixGraph;
+typedef RepGraph<ListRep> ListGraph;
+typedef RepGraph<UMatrixRep> UMatrixGraph;
+typedef RepGraph<UListRep> UListGraph;
+
+#endif
@@ -68,9 +68,15 @@ MinPrio::MinPrio(Comparator compFunc, int maxsize){
     currentSize = 0;
     
     handles = new MinPrio::handle*[MAXSIZE + 1];
-    for(int index = 1; index < MAXSIZE; index++){
+    for(int index = 1; index <= MAXSIZE; index++){
         handles[index] = NULL;
     }
+    pool = new handle[MAXSIZE];
+    unused = new handle*[MAXSIZE];
+    for(int index = 0; index < MAXSIZE; index++){
+        unused[index] = &pool[MAXSIZE - 1 - index];
+    }
+    numUnused = MAXSIZE;
 }
 
 
@@ -79,12 +85,19 @@ MinPrio::MinPrio(Comparator compFunc, int maxsize){
  * The Handle contents are the responsibility of the client (since the client has its own array of handles).
  */
 MinPrio::~MinPrio(){
-    for(int index = 1; index < MAXSIZE; index++){
-        if(handles[index] != NULL){
-            delete handles[index];
-        }
+    delete[] handles;
+    delete[] unused;
+    delete[] pool;
+}
+
+
+/* empty the queue, see minprio.h */
+void MinPrio::clear(){
+    for(int index = 1; index <= currentSize; index++){
+        unused[numUnused++] = handles[index];
+        handles[index] = NULL;
     }
-    delete handles;
+    currentSize = 0;
 }
 
 
@@ -97,14 +110,14 @@ MinPrio::handle* MinPrio::enqueue(void *item){
     if(currentSize == MAXSIZE){
         return NULL;
     }else if(currentSize == 0){
-        handles[1] = new handle;
+        handles[1] = unused[--numUnused];
         handles[1]->pos = 1;
         handles[1]->content = item;
         currentSize++;
         return handles[1];
     }else{
         currentSize++;
-        handles[currentSize] = new handle;
+        handles[currentSize] = unused[--numUnused];
         handles[currentSize]->pos = currentSize;
         handles[currentSize]->content = item;
         int t = currentSize;
@@ -150,10 +163,14 @@ void* MinPrio::dequeueMin(){
         return NULL;
     }
     MinPrio::handle *minNode = handles[1];
+    void* minContent = minNode->content;
+    unused[numUnused++] = minNode;
     handles[1] = handles[currentSize];
-    handles[1]->pos = 1;
     handles[currentSize] = NULL;
     currentSize--;
+    if(currentSize > 0){
+        handles[1]->pos = 1;
+    }
     int t = 1;
     bool cont = true;
     while(2*t <= currentSize){
@@ -168,7 +185,7 @@ void* MinPrio::dequeueMin(){
                 t = 2*t;
                 //delete tempNode;
             }else{
-                return minNode->content;
+                return minContent;
             }
         }
         else{
@@ -195,12 +212,12 @@ void* MinPrio::dequeueMin(){
                     //delete tempNode;
                 }
             }else{
-                return minNode->content;
+                return minContent;
             }
         }
     }
     //printf("end of dequeue\n");
-    return minNode->content;
+    return minContent;
 }
 
 
@@ -229,7 +246,6 @@ void MinPrio::decreasedKey(handle* hand){
             handles[t/2]->pos = t/2;
             
             t = t/2;
-            delete tempNode;
         }else{
             return;
         }
@@ -95,6 +95,15 @@ struct handle {
   ~MinPrio();
 
 
+  /* empty the queue, so it can be used again.
+   * The handles of the items still in it become invalid.
+   *
+   * The queue allocates all maxsize handles up front and recycles them, so
+   * a queue that is cleared and refilled does no heap allocation.
+   */
+  void clear();
+
+
   /* enqueue 
    * If queue is full, return NULL
    * Value of item doesn't matter. Even if NULL, enqueue it anyway
@@ -113,7 +122,7 @@ struct handle {
    * Ensure that for any elements that might be re-ordered, you change their position values
    *
    * If queue is empty, return NULL.
-   * Frees the handle, so client should no longer use handle.
+   * Frees the handle (it goes back to the queue for reuse), so client should no longer use handle.
    */
   void* dequeueMin(); 
 
@@ -140,6 +149,9 @@ struct handle {
   int MAXSIZE; //the max size our queue can get to
   int currentSize; // how many elements are currently in the queue, adjusted by enqueue and dequeue
   handle** handles; // our array of elements. We use handle pointers to represent our elements.
+  handle* pool; // storage for all MAXSIZE handles
+  handle** unused; // stack of the handles of pool not in the queue
+  int numUnused; // size of the unused stack
 };
 
 #endif
@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "minprio.h"
+#include "multiprio.h"
+
+/*
+ * Throughput and rank error of MultiPrio (see multiprio.h) against one
+ * MinPrio behind a mutex, for 1, 2, 4, ... 32 threads (or the number given).
+ *
+ * Throughput: each thread enqueues and dequeues its own items in turn, with
+ * random keys, starting from a queue of PREFILL items, for a fixed number
+ * of operations; printed in million operations per second (a dequeue and
+ * an enqueue count as two).
+ *
+ * Rank error: a queue with the same number of heaps is filled with the
+ * keys 0 .. n-1 and emptied; the s-th dequeue should have returned key s,
+ * so |key - s| is how far from the minimum it was.  Printed as the mean and
+ * the largest.  This is done on one thread, so that it measures the queue
+ * and not the scheduler (a thread preempted between dequeueMin and taking
+ * its number would count as a large error); threads running at the same
+ * time add at most the number of dequeues in flight.
+ *
+ * Build and run with
+ *
+ *   g++ -O2 multibench.cpp minprio.cpp multiprio.cpp -pthread -o multibench
+ *   ./multibench [maxthreads]
+ */
+
+#define PREFILL 100000
+#define OPERATIONS 1000000   /* dequeue/enqueue pairs, split among the threads */
+
+
+/* MinPrio contents for the locked baseline */
+struct keyed {
+    int item;
+    double key;
+};
+
+static int compareKeyed(void* lhs, void* rhs){
+    double a = ((keyed*)lhs)->key, b = ((keyed*)rhs)->key;
+    return (a < b) ? -1 : (a > b) ? 1 : 0;
+}
+
+
+/* the locked baseline: one MinPrio and one mutex */
+struct lockedQueue {
+    MinPrio heap;
+    std::mutex lock;
+    keyed* contents;
+
+    lockedQueue(int n) : heap(&compareKeyed, n) { contents = new keyed[n]; }
+    ~lockedQueue() { delete[] contents; }
+
+    void enqueue(int item, double key){
+        std::lock_guard<std::mutex> hold(lock);
+        contents[item].item = item;
+        contents[item].key = key;
+        heap.enqueue(&contents[item]);
+    }
+
+    int dequeueMin(double* key){
+        std::lock_guard<std::mutex> hold(lock);
+        keyed* k = (keyed*)heap.dequeueMin();
+        if(k == NULL){
+            return -1;
+        }
+        *key = k->key;
+        return k->item;
+    }
+};
+
+
+/* seconds for threads threads to do OPERATIONS dequeue/enqueue pairs on q */
+template <class Q>
+static double throughput(Q& q, int threads){
+    for(int i = 0; i < PREFILL; i++){
+        q.enqueue(i, (double)((i * 7919LL) % PREFILL));
+    }
+    std::vector<std::thread> pool;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for(int t = 0; t < threads; t++){
+        pool.push_back(std::thread([&q, t, threads](){
+            unsigned int r = 777 + t;
+            double key;
+            for(int op = 0; op < OPERATIONS / threads; op++){
+                int item = q.dequeueMin(&key);
+                if(item == -1){
+                    continue;
+                }
+                r = r * 1103515245 + 12345;
+                q.enqueue(item, key + (double)(r % 1000));
+            }
+        }));
+    }
+    for(int t = 0; t < threads; t++){
+        pool[t].join();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+/* mean and largest rank error of dequeueMin on a MultiPrio with queues heaps */
+static void rankError(int queues, double* mean, long long* worst){
+    const int n = PREFILL;
+    MultiPrio q(n, queues);
+    for(int i = 0; i < n; i++){
+        q.enqueue(i, (double)i);
+    }
+    long long total = 0;
+    *worst = 0;
+    double key;
+    for(long long order = 0; q.dequeueMin(&key) != -1; order++){
+        long long error = llabs((long long)key - order);
+        total += error;
+        if(error > *worst){
+            *worst = error;
+        }
+    }
+    *mean = (double)total / n;
+}
+
+
+int main(int argc, char** argv){
+    int maxThreads = (argc > 1) ? atoi(argv[1]) : 32;
+    printf("%d hardware threads\n", (int)std::thread::hardware_concurrency());
+    printf("%8s %8s %14s %14s %12s %12s\n", "threads", "heaps", "locked Mops/s", "multi Mops/s",
+           "mean rank", "worst rank");
+    for(int threads = 1; threads <= maxThreads; threads *= 2){
+        int queues = 2 * threads;
+        lockedQueue locked(PREFILL);
+        double lockedTime = throughput(locked, threads);
+        MultiPrio multi(PREFILL, queues);
+        double multiTime = throughput(multi, threads);
+        double mean;
+        long long worst;
+        rankError(queues, &mean, &worst);
+        printf("%8d %8d %14.2f %14.2f %12.1f %12lld\n", threads, queues,
+               2.0 * OPERATIONS / lockedTime / 1e6, 2.0 * OPERATIONS / multiTime / 1e6, mean, worst);
+    }
+    return 0;
+}
@@ -0,0 +1,244 @@
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "multiprio.h"
+
+/* IMPLEMENTATION OF multiprio.h */
+
+
+/* One of the heaps: an array heap as in minprio.cpp, but from position 0
+ * (the children of i are 2i+1 and 2i+2), behind its own lock.  top is the
+ * smallest key, or INFINITY when the heap is empty; it is written under the
+ * lock and read without it by dequeueMin to choose between two heaps.
+ * Each heap has a cache line to itself, so threads working on different
+ * heaps do not slow each other down.
+ */
+struct alignas(64) MultiPrio::heap {
+    std::mutex lock;
+    std::atomic<double> top;
+    std::vector<entry> items;
+};
+
+
+/* see multiprio.h */
+MultiPrio::MultiPrio(int maxitems, int queues){
+    if(maxitems < 1){
+        maxitems = 1;
+    }
+    if(queues < 1){
+        queues = 2 * (int)std::thread::hardware_concurrency();
+        if(queues < 2){
+            queues = 2;
+        }
+    }
+    MAXITEMS = maxitems;
+    numHeaps = queues;
+    heaps = new heap[numHeaps];
+    for(int q = 0; q < numHeaps; q++){
+        heaps[q].top.store(INFINITY);
+    }
+    where = new std::atomic<int>[MAXITEMS];
+    pos = new int[MAXITEMS];
+    for(int i = 0; i < MAXITEMS; i++){
+        where[i].store(-1);
+        pos[i] = -1;
+    }
+    currentSize.store(0);
+}
+
+
+/* see multiprio.h */
+MultiPrio::~MultiPrio(){
+    delete[] heaps;
+    delete[] where;
+    delete[] pos;
+}
+
+
+/* see multiprio.h */
+int MultiPrio::numQueues(){
+    return numHeaps;
+}
+
+
+/* a heap number chosen uniformly at random, by a xorshift generator of
+ the calling thread */
+int MultiPrio::randomQueue(){
+    static thread_local unsigned int state = 0;
+    if(state == 0){
+        state = (unsigned int)std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+    }
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return (int)(((unsigned long long)state * numHeaps) >> 32);
+}
+
+
+/* move the entry at position at up to its place; called with h locked */
+void MultiPrio::siftUp(heap* h, int at){
+    std::vector<entry>& a = h->items;
+    entry moving = a[at];
+    while(at > 0 && moving.key < a[(at - 1) / 2].key){
+        a[at] = a[(at - 1) / 2];
+        pos[a[at].item] = at;
+        at = (at - 1) / 2;
+    }
+    a[at] = moving;
+    pos[moving.item] = at;
+}
+
+
+/* move the entry at position at down to its place; called with h locked */
+void MultiPrio::siftDown(heap* h, int at){
+    std::vector<entry>& a = h->items;
+    int size = (int)a.size();
+    entry moving = a[at];
+    while(2 * at + 1 < size){
+        int child = 2 * at + 1;
+        if(child + 1 < size && a[child + 1].key < a[child].key){
+            child++;
+        }
+        if(!(a[child].key < moving.key)){
+            break;
+        }
+        a[at] = a[child];
+        pos[a[at].item] = at;
+        at = child;
+    }
+    a[at] = moving;
+    pos[moving.item] = at;
+}
+
+
+/* see multiprio.h */
+bool MultiPrio::enqueue(int item, double key){
+    if(item < 0 || item >= MAXITEMS || !(key < INFINITY)){
+        return false;
+    }
+    //-2 marks the item as on its way into a heap
+    int expected = -1;
+    if(!where[item].compare_exchange_strong(expected, -2)){
+        return false;
+    }
+    currentSize++;
+
+    //a random heap whose lock is free; after a few tries, wait for one
+    heap* h;
+    for(int tries = 0; ; tries++){
+        h = heaps + randomQueue();
+        if(h->lock.try_lock()){
+            break;
+        }
+        if(tries >= 8){
+            h->lock.lock();
+            break;
+        }
+    }
+    entry e = {key, item};
+    h->items.push_back(e);
+    siftUp(h, (int)h->items.size() - 1);
+    h->top.store(h->items[0].key);
+    where[item].store((int)(h - heaps));
+    h->lock.unlock();
+    return true;
+}
+
+
+/* see multiprio.h */
+bool MultiPrio::nonempty(){
+    return currentSize.load() > 0;
+}
+
+
+/* see multiprio.h */
+int MultiPrio::size(){
+    return currentSize.load();
+}
+
+
+/* see multiprio.h */
+int MultiPrio::dequeueMin(double* key){
+    while(currentSize.load() > 0){
+        //the better of two random heaps, or of all if both are empty
+        int a = randomQueue(), b = randomQueue();
+        double topA = heaps[a].top.load(), topB = heaps[b].top.load();
+        int q = (topB < topA) ? b : a;
+        if(!(heaps[q].top.load() < INFINITY)){
+            q = -1;
+            double best = INFINITY;
+            for(int i = 0; i < numHeaps; i++){
+                double t = heaps[i].top.load();
+                if(t < best){
+                    best = t;
+                    q = i;
+                }
+            }
+            if(q == -1){
+                continue;  //an enqueue is on its way
+            }
+        }
+
+        heap* h = heaps + q;
+        if(!h->lock.try_lock()){
+            continue;
+        }
+        if(h->items.empty()){
+            h->lock.unlock();
+            continue;
+        }
+        entry min = h->items[0];
+        entry last = h->items.back();
+        h->items.pop_back();
+        if(!h->items.empty()){
+            h->items[0] = last;
+            siftDown(h, 0);
+            h->top.store(h->items[0].key);
+        }else{
+            h->top.store(INFINITY);
+        }
+        where[min.item].store(-1);
+        h->lock.unlock();
+        currentSize--;
+        if(key != NULL){
+            *key = min.key;
+        }
+        return min.item;
+    }
+    return -1;
+}
+
+
+/* see multiprio.h */
+bool MultiPrio::decreasedKey(int item, double newkey){
+    if(item < 0 || item >= MAXITEMS){
+        return false;
+    }
+    while(true){
+        int q = where[item].load();
+        if(q == -1){
+            return false;
+        }
+        if(q == -2){
+            continue;  //another thread is enqueueing it
+        }
+        heap* h = heaps + q;
+        h->lock.lock();
+        if(where[item].load() != q){  //it moved before we got the lock
+            h->lock.unlock();
+            continue;
+        }
+        int at = pos[item];
+        bool lower = newkey < h->items[at].key;
+        if(lower){
+            h->items[at].key = newkey;
+            siftUp(h, at);
+            h->top.store(h->items[0].key);
+        }
+        h->lock.unlock();
+        return lower;
+    }
+}
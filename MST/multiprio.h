@@ -0,0 +1,103 @@
+#ifndef multiprio_H
+#define multiprio_H
+
+#include <atomic>
+#include <mutex>
+
+/* relaxed min-priority queue for many threads at once (a MultiQueue)
+ *
+ * MinPrio is one array heap, so threads sharing one would take turns on
+ * it.  A MultiPrio is many small heaps, each with its own lock:
+ *  - enqueue puts the item into a randomly chosen heap.
+ *  - dequeueMin looks at the smallest key of two randomly chosen heaps
+ *    (read without locking) and takes the minimum of the better one.
+ *  - If the lock of the heap it wants is taken, a thread picks other heaps
+ *    rather than wait, so threads rarely block each other.
+ *
+ * So dequeueMin does not always return the overall minimum, only one of
+ * the smallest: with q heaps, the rank of the item returned (how many items
+ * in the queue are smaller) is O(q) on average and O(q log q) with high
+ * probability.  With one heap (queues == 1) it is an exact priority queue.
+ * About 2 to 4 heaps per thread work well; more heaps means less waiting
+ * for locks but a bigger rank error.
+ *
+ * Items are the ints 0 .. maxitems-1 (for Prim's, the vertex numbers), as
+ * in BucketPrio, with keys of type double.  The heaps grow as needed; there
+ * are no handles, the queue keeps where each item is.
+ * All operations may be called from any number of threads at once.
+ */
+
+class MultiPrio{
+
+ public:
+
+  /* make an empty queue for items 0 .. maxitems-1 with the given number of
+   * heaps, or twice the number of hardware threads if queues < 1.
+   * If maxitems < 1, it is raised to 1.
+   */
+  MultiPrio(int maxitems, int queues);
+
+
+  /* dispose of the memory owned by the queue */
+  ~MultiPrio();
+
+
+  /* the number of heaps */
+  int numQueues();
+
+
+  /* enqueue item with the given key.
+   * Returns false (and does nothing) if item is out of range or already
+   * in the queue, or if key is not below INFINITY.
+   */
+  bool enqueue(int item, double key);
+
+
+  /* true if the queue has items.  While other threads change the queue
+   * this may be out of date by the time it returns.
+   */
+  bool nonempty();
+
+
+  /* number of items in the queue, with the same caveat */
+  int size();
+
+
+  /* dequeue and return an item with one of the smallest keys (see above),
+   * and put its key in *key if key is not NULL.
+   * If the queue is empty, return -1.
+   */
+  int dequeueMin(double* key);
+
+
+  /* lower the key of an enqueued item to newkey.
+   * Returns false (and does nothing) if item is not in the queue or newkey
+   * is not smaller than its key, as happens when another thread lowered it
+   * further or dequeued it first.
+   */
+  bool decreasedKey(int item, double newkey);
+
+
+ private:
+  MultiPrio(const MultiPrio&) = delete;
+  MultiPrio& operator=(const MultiPrio&) = delete;
+
+  struct entry {
+    double key;
+    int item;
+  };
+  struct heap;  //one of the heaps, see multiprio.cpp
+
+  int randomQueue();             //a heap number chosen uniformly at random
+  void siftUp(heap* h, int at);
+  void siftDown(heap* h, int at);
+
+  int MAXITEMS;                 //items are 0 .. MAXITEMS-1
+  int numHeaps;                 //number of heaps
+  heap* heaps;                  //the heaps
+  std::atomic<int>* where;      //where[i] is the heap holding item i, or -1
+  int* pos;                     //pos[i] is the position of i in that heap (under its lock)
+  std::atomic<int> currentSize; //how many items are in the queue
+};
+
+#endif
@@ -0,0 +1,260 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "parallelprim.h"
+
+/* IMPLEMENTATION OF parallelprim.h */
+
+
+/* Run f(t, from, to) for t = 0 .. threads-1 on threads of their own, where
+ from .. to-1 is the t-th of threads slices of 0 .. n-1. */
+template <typename F>
+static void parallelSlices(int threads, long long n, F f){
+    if(threads <= 1){
+        f(0, 0LL, n);
+        return;
+    }
+    std::vector<std::thread> pool;
+    for(int t = 0; t < threads; t++){
+        pool.push_back(std::thread(f, t, n * t / threads, n * (t + 1) / threads));
+    }
+    for(size_t t = 0; t < pool.size(); t++){
+        pool[t].join();
+    }
+}
+
+
+/* The order every step agrees on: by weight, then by the lower end, then
+ by the higher end (edges are kept with source < target). */
+template <typename W>
+static bool lighter(const typename BasicGraph<W>::Edge& a, const typename BasicGraph<W>::Edge& b){
+    if(a.weight != b.weight){
+        return a.weight < b.weight;
+    }
+    if(a.source != b.source){
+        return a.source < b.source;
+    }
+    return a.target < b.target;
+}
+
+
+/* the edge u-v with weight w, lower end first */
+template <typename W>
+static typename BasicGraph<W>::Edge ordered(int u, int v, W w){
+    typename BasicGraph<W>::Edge e = {std::min(u, v), std::max(u, v), w};
+    return e;
+}
+
+
+/* Grow fragments from the seeds from .. to-1 (see parallelprim.h), adding
+ their edges to tree.  owner[v] is the seed of the fragment holding v, or -1. */
+template <typename W>
+static void growFragments(const BasicGraph<W>* g, std::atomic<int>* owner, int from, int to,
+                          std::vector<typename BasicGraph<W>::Edge>& tree){
+    struct entry {  //an edge out of the fragment, and its end outside
+        typename BasicGraph<W>::Edge e;
+        int to;
+    };
+    auto heavier = [](const entry& a, const entry& b){ return lighter<W>(b.e, a.e); };
+    int n = g->numVerts();
+    int* targets = new int[n];
+    W* weights = new W[n];
+    std::vector<entry> heap;
+
+    for(int seed = from; seed < to; seed++){
+        int fragment = -1;
+        if(!owner[seed].compare_exchange_strong(fragment, seed)){
+            continue;
+        }
+        fragment = seed;
+        heap.clear();
+        int v = seed;
+        for(int size = 1; size < PARALLELPRIM_FRAGMENT; size++){
+            int degree = g->successorEdges(v, targets, weights);
+            for(int index = 0; index < degree; index++){
+                if(owner[targets[index]].load() != fragment){
+                    entry next = {ordered(v, targets[index], weights[index]), targets[index]};
+                    heap.push_back(next);
+                    std::push_heap(heap.begin(), heap.end(), heavier);
+                }
+            }
+
+            //the cheapest edge out of the fragment, skipping those now inside it
+            int found = -1;
+            while(!heap.empty()){
+                std::pop_heap(heap.begin(), heap.end(), heavier);
+                entry top = heap.back();
+                heap.pop_back();
+                int holder = owner[top.to].load();
+                if(holder == fragment){
+                    continue;
+                }
+                if(holder == -1 && owner[top.to].compare_exchange_strong(holder, fragment)){
+                    tree.push_back(top.e);
+                    found = top.to;
+                }
+                break;
+            }
+            if(found == -1){
+                break;  //ran into another fragment, or nothing left to reach
+            }
+            v = found;
+        }
+    }
+    delete[] weights;
+    delete[] targets;
+}
+
+
+/* union-find root of v with path halving */
+static int findSet(int* set, int v){
+    while(set[v] != v){
+        set[v] = set[set[v]];
+        v = set[v];
+    }
+    return v;
+}
+
+
+/* see parallelprim.h */
+template <typename W>
+unique_ptr<BasicGraph<W> > parallelPrim(const BasicGraph<W>* g, int threads){
+    typedef typename BasicGraph<W>::Edge Edge;
+    int n = g->numVerts();
+    if(threads < 1){
+        threads = (int)std::thread::hardware_concurrency();
+    }
+    threads = std::max(1, std::min(threads, n));
+
+    //grow the fragments, each thread from the seeds of its slice
+    std::atomic<int>* owner = new std::atomic<int>[n];
+    for(int v = 0; v < n; v++){
+        owner[v].store(-1);
+    }
+    std::vector<std::vector<Edge> > found(threads);
+    parallelSlices(threads, n, [&](int t, long long from, long long to){
+        growFragments(g, owner, (int)from, (int)to, found[t]);
+    });
+
+    //number the fragments 0 .. fragments-1
+    int* frag = new int[n];
+    int fragments = 0;
+    for(int v = 0; v < n; v++){
+        if(owner[v].load() == v){
+            frag[v] = fragments++;
+        }
+    }
+    for(int v = 0; v < n; v++){
+        frag[v] = frag[owner[v].load()];
+    }
+    delete[] owner;
+
+    //the edges between fragments, each once
+    struct crossing {
+        Edge e;
+        int a;  //fragment of e.source
+        int b;  //fragment of e.target
+    };
+    std::vector<std::vector<crossing> > slices(threads);
+    parallelSlices(threads, n, [&](int t, long long from, long long to){
+        int* targets = new int[n];
+        W* weights = new W[n];
+        for(int v = (int)from; v < (int)to; v++){
+            int degree = g->successorEdges(v, targets, weights);
+            for(int index = 0; index < degree; index++){
+                int u = targets[index];
+                if(u > v && frag[u] != frag[v]){
+                    crossing c = {{v, u, weights[index]}, frag[v], frag[u]};
+                    slices[t].push_back(c);
+                }
+            }
+        }
+        delete[] weights;
+        delete[] targets;
+    });
+    delete[] frag;
+    std::vector<crossing> cross;
+    for(int t = 0; t < threads; t++){
+        cross.insert(cross.end(), slices[t].begin(), slices[t].end());
+        std::vector<crossing>().swap(slices[t]);
+    }
+
+    //Boruvka's on the fragments
+    std::vector<Edge> tree;
+    for(int t = 0; t < threads; t++){
+        tree.insert(tree.end(), found[t].begin(), found[t].end());
+    }
+    int* set = new int[fragments];
+    for(int f = 0; f < fragments; f++){
+        set[f] = f;
+    }
+    std::vector<int> best((size_t)threads * fragments);
+    while(!cross.empty()){
+        //each thread finds the cheapest edge out of each fragment in its slice
+        parallelSlices(threads, (long long)cross.size(), [&](int t, long long from, long long to){
+            int* mine = best.data() + (size_t)t * fragments;
+            std::fill(mine, mine + fragments, -1);
+            for(long long i = from; i < to; i++){
+                int ends[2] = {cross[i].a, cross[i].b};
+                for(int side = 0; side < 2; side++){
+                    int f = ends[side];
+                    if(mine[f] == -1 || lighter<W>(cross[i].e, cross[mine[f]].e)){
+                        mine[f] = (int)i;
+                    }
+                }
+            }
+        });
+        for(int f = 0; f < fragments; f++){
+            int pick = -1;
+            for(int t = 0; t < threads; t++){
+                int i = best[(size_t)t * fragments + f];
+                if(i != -1 && (pick == -1 || lighter<W>(cross[i].e, cross[pick].e))){
+                    pick = i;
+                }
+            }
+            if(pick == -1){
+                continue;
+            }
+            int a = findSet(set, cross[pick].a);
+            int b = findSet(set, cross[pick].b);
+            if(a != b){  //else the fragment at the other end picked it already
+                set[b] = a;
+                tree.push_back(cross[pick].e);
+            }
+        }
+
+        //relabel with the merged fragments and drop the edges now inside one
+        for(int f = 0; f < fragments; f++){
+            set[f] = findSet(set, f);
+        }
+        size_t kept = 0;
+        for(size_t i = 0; i < cross.size(); i++){
+            crossing c = cross[i];
+            c.a = set[c.a];
+            c.b = set[c.b];
+            if(c.a != c.b){
+                cross[kept++] = c;
+            }
+        }
+        cross.resize(kept);
+    }
+    delete[] set;
+
+    unique_ptr<BasicGraph<W> > MST(new BasicGraph<W>(n, ULIST));
+    MST->addEdges(tree.data(), (int)tree.size(), false);
+    return MST;
+}
+
+
+/* the weight types parallelPrim is compiled for, same as BasicGraph in graph.cpp */
+#define PARALLELPRIM_INSTANTIATE(W) \
+    template unique_ptr<BasicGraph<W> > parallelPrim<W>(const BasicGraph<W>*, int);
+
+PARALLELPRIM_INSTANTIATE(float)
+PARALLELPRIM_INSTANTIATE(double)
+PARALLELPRIM_INSTANTIATE(uint16_t)
+PARALLELPRIM_INSTANTIATE(uint32_t)
+PARALLELPRIM_INSTANTIATE(int64_t)
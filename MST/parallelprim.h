@@ -0,0 +1,44 @@
+#ifndef PARALLELPRIM_H
+#define PARALLELPRIM_H
+
+#include "graph.h"
+
+/* Minimum spanning tree on several threads: Prim's from many roots at
+ * once, then Boruvka's on what is left.
+ *
+ * Plain Prim's grows one tree from vertex 0, one vertex at a time.  Here
+ * each thread takes seed vertices from its own range of the vertex numbers
+ * and grows a fragment from each with Prim's on a private heap.  A vertex
+ * joins a fragment when the thread claims it (compare-and-swap on its
+ * owner), so no vertex is in two fragments.  A fragment stops growing when
+ * its cheapest outgoing edge leads to a vertex of another fragment, or
+ * when it has PARALLELPRIM_FRAGMENT vertices (which keeps its heap small);
+ * the thread then goes on with its next unclaimed seed.  Every edge a
+ * fragment takes is the cheapest edge leaving it, so it is in the minimum
+ * tree.
+ *
+ * When all vertices are claimed, the fragments are contracted to single
+ * vertices, keeping the edges between different fragments, and Boruvka's
+ * joins them: each round every fragment takes its cheapest outgoing edge
+ * (found by all threads, each over a slice of the edges), and the number
+ * of fragments at least halves.
+ *
+ * Edges are compared by weight, then by their lower and higher end, so all
+ * weights are in effect different and every step agrees on one minimum
+ * tree; which tree that is does not depend on the number of threads or on
+ * their timing.  Meant for big sparse graphs, where the fragments grow in
+ * cache-friendly neighborhoods; same assumptions as minSpanTree.
+ */
+
+
+#define PARALLELPRIM_FRAGMENT 4096  /* most vertices a fragment grows to */
+
+
+/* Return a minimum spanning tree (a forest if g is disconnected) as a new
+ * ULIST graph, computed on the given number of threads (the number of
+ * hardware threads if threads < 1).
+ */
+template <typename W>
+unique_ptr<BasicGraph<W> > parallelPrim(const BasicGraph<W>* g, int threads);
+
+#endif
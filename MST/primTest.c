@@ -23,13 +23,12 @@ float edge_check(Graph *g, int src, int dst, bool *check) {
     // This node has been visited
     check[src] = true;
     
-    int *succ = g->successors(src);
+    unique_ptr<int[]> succ = g->successors(src);
     for (int i = 0; succ[i] >= 0; i++) {
         int a = succ[i];
         
         if (a == dst) {
             // This is an edge leading directly to the result.
-            delete succ;
             return g->edge(src, dst);
         } else if (!check[a]) {
             // Get the best edge on the path if it exists
@@ -37,13 +36,11 @@ float edge_check(Graph *g, int src, int dst, bool *check) {
             if (!isnan(w)) {
                 // There is a path.
                 float e = g->edge(src, a);
-                delete succ;
                 return w > e ? w : e;
             }
         }
     }
 
-    delete succ;
     return nan("1");
 }
 
@@ -55,7 +52,7 @@ bool isValidPrim(Graph *g, Graph *mst) {
             return false;
 
         // Get every outgoing edge in the tree.
-        int *succ = g->successors(i);
+        unique_ptr<int[]> succ = g->successors(i);
 
         for (int j = 0; succ[j] >= 0; j++) {
             if (succ[j] < i)
@@ -68,25 +65,20 @@ bool isValidPrim(Graph *g, Graph *mst) {
             
             // Get the largest weight in the tree
             float f = edge_check(mst, i, succ[j], check);
-            delete check;
+            delete[] check;
 
             // If the largest weight is bigger than the non-mst edge, fail
             // Similar if there is no path in the MST, because there must be.
             if (isnan(f) || f > g->edge(i, succ[j])) {
-                delete succ;
                 return false;
             }
         }
 
-        delete succ;
-
         succ = mst->successors(i);
         for (int j = 0; succ[j] >= 0; j++)
             if (mst->edge(i, succ[j]) != mst->edge(succ[j], i))
                 return false;
 
-        delete succ;
-
     }
 
     return true;
@@ -109,30 +101,28 @@ int main(int argc, char* argv[]){
   }
   printf("\n***************************************\nTesting %s\n", argv[1]);
   char* filepath = argv[1];
-  GraphInfo gi;
-  gi = readGraphMakeSymm(filepath, LIST ); //could also be matrix
+  GraphInfo gi = readGraphMakeSymm(filepath, LIST ); //could also be matrix
   
   //uncomment to print graph
   /*printf("Original Graph:\n");
     writeGraph(gi);*/
   
   /* compute the MST and print that */
-  Graph* orig = gi->graph; 
-  Graph* tree = minSpanTree(orig);
+  Graph* orig = gi.graph.get(); 
+  unique_ptr<Graph> tree = minSpanTree(orig);
 
   //uncomment out to print MST
   /*
   printf("\n A min spanning tree for %s:\n", filepath);
-  gi->graph = tree; 
+  gi.graph = std::move(tree); 
   writeGraph(gi);
   */
   
-  if (isValidPrim(orig, tree))
+  if (isValidPrim(orig, tree.get()))
     printf("MST Verification: PASSED\n");
   else
     printf("MST Verification: FAILED\n");
 
-  delete orig;
-  delete tree;
+  //gi and tree free themselves
 }
 
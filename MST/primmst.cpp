@@ -44,84 +44,33 @@
  * (using the & operator and the function name)
  */
 
-struct content{
-    int node;
-    float currentDistance;
-};
-
-int compare(void* lhs, void* rhs){
-    //handle what type of pointer (cast to my struct)
-    float left = ((content*)lhs)->currentDistance;
-    float right = ((content*)rhs)->currentDistance;
-    
-    if(left < right){
-        return -1;
-    }
-    else if(left > right){
-        return 1;
-    }
-    else return 0;
+/* see primmst.h */
+template <typename W>
+bool integralWeights(const BasicGraph<W>* g, int* maxWeight){
+    int n = g->numVerts();
+    int* targets = new int[n];
+    W* weights = new W[n];
+    bool integral = integralWeights(g, maxWeight, targets, weights);
+    delete[] targets;
+    delete[] weights;
+    return integral;
 }
 
-Graph* minSpanTree(Graph* h){
-    Graph* MST = new Graph(h->numVerts(), 0);
-    int numVertices = MST->numVerts();
-    content* chosenNode = new content;
-    MinPrio* PQ = new MinPrio(&compare, numVertices);
-    int* link = new int[numVertices];
-    int* inQ = new int[numVertices];
-    MinPrio::handle** handles = new MinPrio::handle*[numVertices];
-    
-    for(int index = 0; index < numVertices; index++){
-        link[index] = 0;
-        handles[index] = NULL;
-        inQ[index] = 1;
-    }
-    
-    chosenNode->node = 0;
-    chosenNode->currentDistance = 0;
-    handles[0] = PQ->enqueue(chosenNode);
-    
-    for(int index = 1; index < numVertices; index++){
-        content* currentNode = new content;
-        currentNode->node = index;
-        currentNode->currentDistance = INFINITY;
-        handles[index] = PQ->enqueue(currentNode);
-    }
-    
-    while(PQ->nonempty()){
-        int v = ((content*)(PQ->dequeueMin()))->node;
-        printf("%d\n",v);
-        inQ[v] = 0;
-        handles[v] = NULL;
-        int* suc = h->successors(v);
-        
-        for(int index = 0; suc[index] != -1; index++){
-            if(inQ[suc[index]] == 1 && h->edge(suc[index], v) <
-                ((content*)handles[suc[index]]->content)->currentDistance){
-                //seg faults in the if statement
-                link[suc[index]] = v;
-                ((content*)handles[suc[index]]->content)->currentDistance = h->edge(suc[index], v);
-                PQ->decreasedKey(handles[suc[index]]);
-            }
-        }
-    }
-   
-    for(int index = 0; index < numVertices; index++){
-        MST->addEdge(index, link[index], h->edge(index, link[index]));
-        MST->addEdge(link[index], index, h->edge(link[index], index));
-    }
-    
-    delete chosenNode;
-    delete PQ;
-    delete link;
-    delete inQ;
-    for(int index = 0; index < numVertices; index++){
-        if(handles[index] != NULL){
-            delete handles[index];
-        }
-    }
-    delete handles;
-    
-    return MST;
+/* see primmst.h */
+template <typename W>
+unique_ptr<BasicGraph<W> > minSpanTree(const BasicGraph<W>* h){
+    PrimNoVisitor vis;
+    return minSpanTree(h, vis);
 }
+
+
+/* the weight types minSpanTree is compiled for, same as BasicGraph in graph.cpp */
+#define PRIMMST_INSTANTIATE(W) \
+    template bool integralWeights<W>(const BasicGraph<W>*, int*); \
+    template unique_ptr<BasicGraph<W> > minSpanTree<W>(const BasicGraph<W>*);
+
+PRIMMST_INSTANTIATE(float)
+PRIMMST_INSTANTIATE(double)
+PRIMMST_INSTANTIATE(uint16_t)
+PRIMMST_INSTANTIATE(uint32_t)
+PRIMMST_INSTANTIATE(int64_t)
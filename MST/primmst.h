@@ -2,7 +2,12 @@
 #define PRIMMST_H
 
 #include "graph.h"
+#include "graphrep.h"
 #include "minprio.h"
+#include "bucketprio.h"
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
 
 /* Assume g is non-null pointer to non-empty graph.
  * Assume g is a symmetric graph, so it can be 
@@ -11,9 +16,11 @@
  * for every u,v.)
  * Assume g is a connected graph.
  * 
- * Return a minimum spanning tree, as a new graph.
+ * Return a minimum spanning tree, as a new graph owned by the unique_ptr.
  * (So it will have the same number of vertices, 
  * but only some of the edges.  Weights same as in g.)
+ * The tree is an undirected ULIST graph (see graph.h), so each tree
+ * edge is stored once but can be looked up in both directions.
  * 
  * Implement this using Prim's algorithm.  The implementation only
  * needs to access the input graph via the graph.h API, so 
@@ -32,8 +39,615 @@
  * For function pointers, simply create a function that matches the template defined in minprio.h, 
  * and when calling the Queue's constructor, pass in the address of that function,
  * (using the & operator and the function name)
+ *
+ * Works for every weight type BasicGraph is compiled for (see graph.h);
+ * "INFINITY" above is WeightTraits<W>::noEdge().
+ */
+
+template <typename W>
+unique_ptr<BasicGraph<W> > minSpanTree(const BasicGraph<W>* g);
+
+
+/* Visitor hooks for minSpanTree.
+ * A visitor is any class with the five member functions below; minSpanTree
+ * is a template on the visitor type, so the calls are resolved at compile time
+ * and empty hooks are inlined away to nothing.
+ * Derive from PrimNoVisitor and override only the hooks you need.
+ *
+ *  runStarted(total)           a run over total vertices begins, before any
+ *                              other hook.
+ *  vertexFinalized(v)          v was dequeued; its distance will not change again.
+ *  edgeRelaxed(u, v, w)        the distance of v was lowered to w through u.
+ *  treeEdgeAdded(u, v, w)      the edge u-v with weight w joined the tree (u is
+ *                              the vertex already in the tree).
+ *  shouldStop(done, total)     done of the total vertices are finalized; return
+ *                              true to stop here.  Called every
+ *                              PRIM_CHECK_INTERVAL vertices, and once at the end
+ *                              (done == total, the answer then ignored).
+ *
+ * Hooks are called in the order Prim's algorithm performs the steps, so
+ * treeEdgeAdded(link[v], v, ...) comes right after vertexFinalized(v).
+ *
+ * When shouldStop returns true, the result is the part of the tree built
+ * so far: the edges to the vertices finalized up to then.  Every other
+ * vertex is left without a tree edge.
+ */
+#define PRIM_CHECK_INTERVAL 4096
+
+struct PrimNoVisitor {
+  void runStarted(int) {}
+  void vertexFinalized(int) {}
+  template <typename W> void edgeRelaxed(int, int, W) {}
+  template <typename W> void treeEdgeAdded(int, int, W) {}
+  bool shouldStop(int, int) { return false; }
+};
+
+/* Prints every finalized vertex on its own line, as minSpanTree used to. */
+struct PrimTraceVisitor : PrimNoVisitor {
+  void vertexFinalized(int v) { printf("%d\n", v); }
+};
+
+/* A time budget for long runs, as a visitor: stops Prim's when the
+ * cancellation token is set (from any thread) or the deadline has passed,
+ * and reports the fraction of vertices finalized to a progress function.
+ * Each is optional.  The checks happen in shouldStop, so every
+ * PRIM_CHECK_INTERVAL vertices: one atomic load and one clock read.
+ *
+ *     std::atomic<bool> cancel(false);
+ *     PrimBudget budget;
+ *     budget.setCancel(&cancel);
+ *     budget.setDeadline(0.250);            //seconds from now
+ *     unique_ptr<BasicGraph<double> > tree = minSpanTree(g, budget);
+ *     if(budget.stopped()) ... tree is partial ...
+ */
+class PrimBudget : public PrimNoVisitor {
+
+ public:
+  typedef void (*Progress)(double fraction, void* context);
+
+  PrimBudget() : cancel(NULL), hasDeadline(false), progress(NULL), context(NULL),
+                 wasCancelled(false), wasTimedOut(false) {}
+
+  /* stop once *token is true; NULL for no token */
+  void setCancel(const std::atomic<bool>* token) { cancel = token; }
+
+  /* stop once this many seconds from now have passed */
+  void setDeadline(double seconds){
+    hasDeadline = true;
+    deadline = std::chrono::steady_clock::now() +
+               std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                   std::chrono::duration<double>(seconds));
+  }
+
+  /* call report(fraction finalized, ctx) at every check; NULL for none */
+  void setProgress(Progress report, void* ctx) { progress = report; context = ctx; }
+
+  /* why the last run stopped early, if it did */
+  bool cancelled() { return wasCancelled; }
+  bool timedOut() { return wasTimedOut; }
+  bool stopped() { return wasCancelled || wasTimedOut; }
+
+  /* a budget can be used for several runs; each starts with a clean slate */
+  void runStarted(int) { wasCancelled = wasTimedOut = false; }
+
+  bool shouldStop(int done, int total){
+    if(progress != NULL){
+      progress(total == 0 ? 1.0 : (double)done / total, context);
+    }
+    if(done == total){
+      return false;
+    }
+    if(cancel != NULL && cancel->load(std::memory_order_relaxed)){
+      wasCancelled = true;
+      return true;
+    }
+    if(hasDeadline && std::chrono::steady_clock::now() >= deadline){
+      wasTimedOut = true;
+      return true;
+    }
+    return false;
+  }
+
+ private:
+  const std::atomic<bool>* cancel;
+  bool hasDeadline;
+  std::chrono::steady_clock::time_point deadline;
+  Progress progress;
+  void* context;
+  bool wasCancelled;
+  bool wasTimedOut;
+};
+
+/* Same as minSpanTree(g), but reports each step of the algorithm to vis. */
+template <typename W, class Visitor>
+unique_ptr<BasicGraph<W> > minSpanTree(const BasicGraph<W>* g, Visitor& vis);
+
+
+/* minSpanTree for any type of the graph concept (see graphrep.h), such as
+ * RepGraph<ListRep, float>, compiled for that type so the reads of the
+ * adjacency are inlined.  The BasicGraph versions above come down to these,
+ * on a RepView of the graph's representation.
+ */
+template <class G>
+unique_ptr<BasicGraph<typename G::weight_type> > minSpanTree(const G* g);
+
+template <class G, class Visitor>
+unique_ptr<BasicGraph<typename G::weight_type> > minSpanTree(const G* g, Visitor& vis);
+
+
+/* Weights up to this bound (inclusive) are small enough for the bucket queue. */
+#define PRIM_BUCKET_MAXWEIGHT 1048575
+
+/* ... and the buckets are used only when there are at most this many per
+ * vertex and edge of the graph, since they are allocated and cleared whole:
+ * a small graph with one big weight is cheaper on the heap. */
+#define PRIM_BUCKET_PER_ITEM 8
+
+/* True if every edge weight of g is a whole number no bigger than 
+ * PRIM_BUCKET_MAXWEIGHT, and the largest is at most PRIM_BUCKET_PER_ITEM
+ * times V + E (E as the sum of the out degrees); then *maxWeight is set to
+ * the largest weight (0 for a graph without edges).
+ *
+ * minSpanTree uses this to pick its queue: when it returns true, Prim's runs
+ * on a BucketPrio (see bucketprio.h) keyed by the integer weights, and
+ * otherwise on the comparison based MinPrio.  Both produce a minimum tree;
+ * when there are equal weights they may pick different ones.
+ */
+template <typename W>
+bool integralWeights(const BasicGraph<W>* g, int* maxWeight);
+
+/* Same, for any type of the graph concept, using the caller's buffers for
+ * successorEdges (numVerts() long), so nothing is allocated.
+ */
+template <class G>
+bool integralWeights(const G* g, int* maxWeight, int* targets, typename G::weight_type* weights);
+
+
+/* A reusable workspace for Prim's algorithm.
+ * minSpanTree allocates its arrays, queue and queue handles on every call.
+ * A PrimSolver keeps them between calls and only grows them when a bigger
+ * graph (or, for the bucket queue, a bigger weight) comes along, so calling
+ * solve again and again on graphs of similar size does no heap allocation.
+ *
+ * After solve(g), the tree is in parent() and weight(): for each vertex v,
+ * parent()[v] is the vertex it was reached from, or -1 if Prim's started a
+ * tree at v (vertex 0, and the first vertex of each further component of a
+ * disconnected graph), and weight()[v] is the weight of that edge.  They are
+ * valid until the next solve.  tree() builds the same tree minSpanTree
+ * returns (this allocates, of course).  If the visitor stopped the run,
+ * complete() is false and all of these hold the partial tree.
+ */
+template <typename W>
+class PrimSolver {
+
+ public:
+
+  PrimSolver();
+  ~PrimSolver();
+
+  /* run Prim's on g, with the same assumptions as minSpanTree */
+  void solve(const BasicGraph<W>& g);
+
+  /* same, reporting each step to vis as minSpanTree(g, vis) does */
+  template <class Visitor>
+  void solve(const BasicGraph<W>& g, Visitor& vis);
+
+  /* same, for any type of the graph concept with weight type W (graphrep.h) */
+  template <class G>
+  void solve(const G& g);
+
+  template <class G, class Visitor>
+  void solve(const G& g, Visitor& vis);
+
+  /* the result of the last solve, see above */
+  int numVerts();
+  const int* parent();
+  const W* weight();
+  double totalWeight();
+  unique_ptr<BasicGraph<W> > tree();
+
+  /* false if the visitor's shouldStop ended the last solve early */
+  bool complete();
+
+  /* how many vertices the last solve finalized (numVerts() if complete) */
+  int numFinalized();
+
+  /* Whether solve may use the bucket queue when integralWeights allows it
+   * (the default), or always uses the MinPrio heap.
+   */
+  void allowBuckets(bool allowed);
+
+  /* Tell the next solve that integralWeights already held for its graph,
+   * with this largest weight, so it does not look at the weights again
+   * (computeMST has, to pick the engine).  Only for that one solve.
+   */
+  void knownWeights(int maxWeight);
+
+  /* true if the last solve ran on the bucket queue */
+  bool usedBuckets();
+
+ private:
+  PrimSolver(const PrimSolver&) = delete;
+  PrimSolver& operator=(const PrimSolver&) = delete;
+
+  void reserve(int n);
+  template <class G, class Visitor> void run(const G& g, Visitor& vis);
+  template <class G, class Visitor> void solveHeap(const G& g, Visitor& vis);
+  template <class G, class Visitor> void solveBucket(const G& g, Visitor& vis, int maxWeight);
+
+  struct content {  //what the MinPrio holds: a vertex and its current distance
+    int node;
+    W currentDistance;
+  };
+  static int compare(void* lhs, void* rhs);
+
+  int n;              //number of vertices of the last graph solved
+  int finalized;      //number of vertices it finalized
+  bool stopped;       //true if it was stopped early
+  bool bucketsAllowed; //see allowBuckets
+  bool bucketsUsed;   //the last solve ran on buckets
+  int knownMax;       //see knownWeights, or -1 to look at the weights
+  int capacity;       //the arrays below have room for capacity vertices
+  int* link;          //the parent of each vertex, -1 for a root
+  W* dist;            //current distance of each vertex, then the tree edge weight
+  bool* inQ;          //true while the vertex is in the queue
+  int* targets;       //buffer for successorEdges
+  W* weights;         //buffer for successorEdges
+  content* contents;  //queue contents for MinPrio, one per vertex
+  MinPrio::handle** handles;  //the MinPrio handle of each vertex
+  MinPrio* heap;      //for non-integer weights
+  BucketPrio* buckets;        //for small integer weights, made when first needed
+};
+
+
+/* IMPLEMENTATION OF THE TEMPLATES (needs to be visible to every caller) */
+
+/* see above */
+template <class G>
+bool integralWeights(const G* g, int* maxWeight, int* targets, typename G::weight_type* weights){
+    typedef typename G::weight_type W;
+    int n = g->numVerts();
+    W largest = 0;
+    long long edges = 0;
+    for(int v = 0; v < n; v++){
+        int degree = g->successorEdges(v, targets, weights);
+        edges += degree;
+        for(int index = 0; index < degree; index++){
+            W w = weights[index];
+            if((double)w != floor((double)w) || (double)w > PRIM_BUCKET_MAXWEIGHT){
+                return false;
+            }
+            if(w > largest){
+                largest = w;
+            }
+        }
+    }
+    if((double)largest > (double)PRIM_BUCKET_PER_ITEM * ((double)n + (double)edges)){
+        return false;
+    }
+    *maxWeight = (int)largest;
+    return true;
+}
+
+template <typename W>
+PrimSolver<W>::PrimSolver(){
+    n = capacity = finalized = 0;
+    stopped = false;
+    bucketsAllowed = true;
+    bucketsUsed = false;
+    knownMax = -1;
+    link = NULL;
+    dist = NULL;
+    inQ = NULL;
+    targets = NULL;
+    weights = NULL;
+    contents = NULL;
+    handles = NULL;
+    heap = NULL;
+    buckets = NULL;
+}
+
+template <typename W>
+PrimSolver<W>::~PrimSolver(){
+    delete[] link;
+    delete[] dist;
+    delete[] inQ;
+    delete[] targets;
+    delete[] weights;
+    delete[] contents;
+    delete[] handles;
+    delete heap;
+    delete buckets;
+}
+
+/* make room for graphs of size vertices; only allocates when there is not */
+template <typename W>
+void PrimSolver<W>::reserve(int size){
+    if(size <= capacity){
+        return;
+    }
+    delete[] link;
+    delete[] dist;
+    delete[] inQ;
+    delete[] targets;
+    delete[] weights;
+    delete[] contents;
+    delete[] handles;
+    delete heap;
+    delete buckets;
+
+    capacity = size;
+    link = new int[size];
+    dist = new W[size];
+    inQ = new bool[size];
+    targets = new int[size];
+    weights = new W[size];
+    contents = new content[size];
+    handles = new MinPrio::handle*[size];
+    heap = new MinPrio(&compare, size);
+    buckets = NULL;
+}
+
+/* Comparator for the MinPrio contents, see minprio.h */
+template <typename W>
+int PrimSolver<W>::compare(void* lhs, void* rhs){
+    W left = ((content*)lhs)->currentDistance;
+    W right = ((content*)rhs)->currentDistance;
+
+    if(left < right){
+        return -1;
+    }
+    else if(left > right){
+        return 1;
+    }
+    else return 0;
+}
+
+template <typename W>
+void PrimSolver<W>::solve(const BasicGraph<W>& g){
+    PrimNoVisitor vis;
+    solve(g, vis);
+}
+
+/* run on the representation of g, known at compile time from here on */
+template <typename W>
+template <class Visitor>
+void PrimSolver<W>::solve(const BasicGraph<W>& g, Visitor& vis){
+    switch(g.representation()){
+    case MATRIX:  { RepView<MatrixRep, W> view(g);  run(view, vis); break; }
+    case UMATRIX: { RepView<UMatrixRep, W> view(g); run(view, vis); break; }
+    case ULIST:   { RepView<UListRep, W> view(g);   run(view, vis); break; }
+    default:      { RepView<ListRep, W> view(g);    run(view, vis); break; }
+    }
+}
+
+template <typename W>
+template <class G>
+void PrimSolver<W>::solve(const G& g){
+    PrimNoVisitor vis;
+    run(g, vis);
+}
+
+template <typename W>
+template <class G, class Visitor>
+void PrimSolver<W>::solve(const G& g, Visitor& vis){
+    run(g, vis);
+}
+
+/* pick the queue, see integralWeights */
+template <typename W>
+template <class G, class Visitor>
+void PrimSolver<W>::run(const G& g, Visitor& vis){
+    reserve(g.numVerts());
+    n = g.numVerts();
+    finalized = 0;
+    stopped = false;
+    vis.runStarted(n);
+    int maxWeight = knownMax;
+    knownMax = -1;
+    bucketsUsed = bucketsAllowed
+                  && (maxWeight >= 0 || integralWeights(&g, &maxWeight, targets, weights));
+    if(bucketsUsed){
+        solveBucket(g, vis, maxWeight);
+    }else{
+        solveHeap(g, vis);
+    }
+
+    if(stopped){
+        //keep only the edges to finalized vertices
+        for(int index = 0; index < n; index++){
+            if(inQ[index]){
+                link[index] = -1;
+            }
+        }
+    }else{
+        vis.shouldStop(n, n);
+    }
+}
+
+/* Prim's on the MinPrio heap */
+template <typename W>
+template <class G, class Visitor>
+void PrimSolver<W>::solveHeap(const G& g, Visitor& vis){
+    const W infinity = WeightTraits<W>::noEdge();
+    MinPrio* PQ = heap;
+    PQ->clear();
+
+    for(int index = 0; index < n; index++){
+        link[index] = -1;
+        inQ[index] = true;
+        contents[index].node = index;
+        contents[index].currentDistance = (index == 0 ? 0 : infinity);
+        handles[index] = PQ->enqueue(&contents[index]);
+    }
+
+    while(PQ->nonempty()){
+        int v = ((content*)(PQ->dequeueMin()))->node;
+        vis.vertexFinalized(v);
+        inQ[v] = false;
+        handles[v] = NULL;
+        if(link[v] != -1){
+            vis.treeEdgeAdded(link[v], v, contents[v].currentDistance);
+        }
+        int degree = g.successorEdges(v, targets, weights);
+
+        for(int index = 0; index < degree; index++){
+            int u = targets[index];
+            W w = weights[index];
+            if(inQ[u] && w < contents[u].currentDistance){
+                link[u] = v;
+                contents[u].currentDistance = w;
+                PQ->decreasedKey(handles[u]);
+                vis.edgeRelaxed(v, u, w);
+            }
+        }
+        if(++finalized % PRIM_CHECK_INTERVAL == 0 && vis.shouldStop(finalized, n)){
+            stopped = true;
+            break;
+        }
+    }
+
+    for(int index = 0; index < n; index++){
+        dist[index] = contents[index].currentDistance;
+    }
+}
+
+/* Prim's on the BucketPrio queue, for integer weights 0 .. maxWeight.
+ * Key maxWeight+1 stands for INFINITY, so the steps are the same as solveHeap.
  */
+template <typename W>
+template <class G, class Visitor>
+void PrimSolver<W>::solveBucket(const G& g, Visitor& vis, int maxWeight){
+    int infinity = maxWeight + 1;
+    if(buckets == NULL || buckets->maxKey() < infinity){
+        delete buckets;
+        buckets = new BucketPrio(infinity, capacity);
+    }
+    BucketPrio* PQ = buckets;
+    PQ->clear();
+
+    //a vertex still in the queue with link -1 is at INFINITY
+    for(int index = 0; index < n; index++){
+        link[index] = -1;
+        inQ[index] = true;
+        dist[index] = 0;
+        PQ->enqueue(index, index == 0 ? 0 : infinity);
+    }
+
+    while(PQ->nonempty()){
+        int v = PQ->dequeueMin();
+        vis.vertexFinalized(v);
+        inQ[v] = false;
+        if(link[v] != -1){
+            vis.treeEdgeAdded(link[v], v, dist[v]);
+        }
+        int degree = g.successorEdges(v, targets, weights);
+
+        for(int index = 0; index < degree; index++){
+            int u = targets[index];
+            W w = weights[index];
+            if(inQ[u] && (link[u] == -1 || w < dist[u])){
+                link[u] = v;
+                dist[u] = w;
+                PQ->decreasedKey(u, (int)w);
+                vis.edgeRelaxed(v, u, w);
+            }
+        }
+        if(++finalized % PRIM_CHECK_INTERVAL == 0 && vis.shouldStop(finalized, n)){
+            stopped = true;
+            break;
+        }
+    }
+}
+
+template <typename W>
+int PrimSolver<W>::numVerts(){
+    return n;
+}
+
+template <typename W>
+const int* PrimSolver<W>::parent(){
+    return link;
+}
+
+template <typename W>
+const W* PrimSolver<W>::weight(){
+    return dist;
+}
+
+template <typename W>
+bool PrimSolver<W>::complete(){
+    return !stopped;
+}
+
+template <typename W>
+int PrimSolver<W>::numFinalized(){
+    return finalized;
+}
+
+template <typename W>
+void PrimSolver<W>::allowBuckets(bool allowed){
+    bucketsAllowed = allowed;
+}
+
+template <typename W>
+void PrimSolver<W>::knownWeights(int maxWeight){
+    knownMax = maxWeight;
+}
+
+template <typename W>
+bool PrimSolver<W>::usedBuckets(){
+    return bucketsUsed;
+}
+
+template <typename W>
+double PrimSolver<W>::totalWeight(){
+    double total = 0;
+    for(int index = 0; index < n; index++){
+        if(link[index] != -1){
+            total += (double)dist[index];
+        }
+    }
+    return total;
+}
+
+/* the tree of the last solve as a ULIST graph, see minSpanTree */
+template <typename W>
+unique_ptr<BasicGraph<W> > PrimSolver<W>::tree(){
+    unique_ptr<BasicGraph<W> > MST(new BasicGraph<W>(n, ULIST));
+    typename BasicGraph<W>::Edge* edges = new typename BasicGraph<W>::Edge[n];
+    int count = 0;
+    for(int index = 0; index < n; index++){
+        if(link[index] != -1){
+            edges[count].source = link[index];
+            edges[count].target = index;
+            edges[count].weight = dist[index];
+            count++;
+        }
+    }
+    MST->addEdges(edges, count, false);
+    delete[] edges;
+    return MST;
+}
+
+template <typename W, class Visitor>
+unique_ptr<BasicGraph<W> > minSpanTree(const BasicGraph<W>* h, Visitor& vis){
+    PrimSolver<W> solver;
+    solver.solve(*h, vis);
+    return solver.tree();
+}
+
+template <class G>
+unique_ptr<BasicGraph<typename G::weight_type> > minSpanTree(const G* g){
+    PrimNoVisitor vis;
+    return minSpanTree(g, vis);
+}
 
-Graph* minSpanTree(Graph* g);
+template <class G, class Visitor>
+unique_ptr<BasicGraph<typename G::weight_type> > minSpanTree(const G* g, Visitor& vis){
+    PrimSolver<typename G::weight_type> solver;
+    solver.solve(*g, vis);
+    return solver.tree();
+}
 
 #endif
@@ -0,0 +1,172 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+#include "reorder.h"
+#include "primmst.h"
+
+/* IMPLEMENTATION OF reorder.h */
+
+
+/* Breadth first search from start, appending the visited vertices to
+ order[*count ...].  If byDegree, the neighbors of each vertex are visited
+ in increasing degree (as Cuthill-McKee does), otherwise in successor order.
+ The queue is the order array itself; targets and weights are buffers for
+ successorEdges. */
+template <typename W>
+static void bfsFrom(const BasicGraph<W>* g, int start, bool byDegree, int* degree,
+                    bool* seen, int* order, int* count, int* targets, W* weights){
+    int head = *count;
+    order[(*count)++] = start;
+    seen[start] = true;
+    while(head < *count){
+        int v = order[head++];
+        int d = g->successorEdges(v, targets, weights);
+        int first = *count;
+        for(int index = 0; index < d; index++){
+            if(!seen[targets[index]]){
+                seen[targets[index]] = true;
+                order[(*count)++] = targets[index];
+            }
+        }
+        if(byDegree){
+            std::stable_sort(order + first, order + *count,
+                             [degree](int a, int b){ return degree[a] < degree[b]; });
+        }
+    }
+}
+
+
+/* see reorder.h */
+template <typename W>
+unique_ptr<int[]> vertexOrder(const BasicGraph<W>* g, int method){
+    if(method != ORDER_BFS && method != ORDER_RCM && method != ORDER_DEGREE){
+        return NULL;
+    }
+    int n = g->numVerts();
+    int* degree = new int[n];
+    int* order = new int[n]; //order[i] is the vertex that gets number i
+    for(int v = 0; v < n; v++){
+        degree[v] = g->outDegree(v);
+        order[v] = v;
+    }
+
+    if(method == ORDER_DEGREE){
+        std::stable_sort(order, order + n,
+                         [degree](int a, int b){ return degree[a] > degree[b]; });
+    }else{
+        bool* seen = new bool[n];
+        for(int v = 0; v < n; v++){
+            seen[v] = false;
+        }
+        //start candidates: in vertex order for BFS, by degree for RCM
+        int* starts = new int[n];
+        for(int v = 0; v < n; v++){
+            starts[v] = v;
+        }
+        if(method == ORDER_RCM){
+            std::stable_sort(starts, starts + n,
+                             [degree](int a, int b){ return degree[a] < degree[b]; });
+        }
+        int* targets = new int[n];
+        W* weights = new W[n];
+        int count = 0;
+        for(int i = 0; i < n; i++){
+            if(!seen[starts[i]]){
+                bfsFrom(g, starts[i], method == ORDER_RCM, degree, seen, order, &count, targets, weights);
+            }
+        }
+        delete[] weights;
+        delete[] targets;
+        if(method == ORDER_RCM){
+            std::reverse(order, order + n);
+        }
+        delete[] starts;
+        delete[] seen;
+    }
+
+    unique_ptr<int[]> perm = inversePermutation(order, n);
+    delete[] order;
+    delete[] degree;
+    return perm;
+}
+
+
+/* see reorder.h */
+unique_ptr<int[]> inversePermutation(const int* perm, int n){
+    unique_ptr<int[]> inv(new int[n]);
+    for(int v = 0; v < n; v++){
+        inv[perm[v]] = v;
+    }
+    return inv;
+}
+
+
+/* see reorder.h */
+template <typename W>
+unique_ptr<BasicGraph<W> > permuteGraph(const BasicGraph<W>* g, const int* perm, int rep){
+    int n = g->numVerts();
+    unique_ptr<BasicGraph<W> > h(new BasicGraph<W>(n, rep));
+    std::vector<typename BasicGraph<W>::Edge> edges;
+    int* targets = new int[n];
+    W* weights = new W[n];
+    for(int v = 0; v < n; v++){
+        int d = g->successorEdges(v, targets, weights);
+        for(int index = 0; index < d; index++){
+            typename BasicGraph<W>::Edge e = {perm[v], perm[targets[index]], weights[index]};
+            edges.push_back(e);
+        }
+    }
+    delete[] weights;
+    delete[] targets;
+    h->addEdges(edges.data(), (int)edges.size(), false);
+    return h;
+}
+
+
+/* see reorder.h */
+template <typename W>
+unique_ptr<int[]> reorderGraphInfo(basicgraphinfo<W>& gi, int method){
+    unique_ptr<int[]> perm = vertexOrder(gi.graph.get(), method);
+    if(perm == NULL){
+        return NULL;
+    }
+    int n = gi.graph->numVerts();
+    gi.graph = permuteGraph(gi.graph.get(), perm.get(), gi.graph->representation());
+
+    vector<string> names(n);
+    for(int v = 0; v < n; v++){
+        names[perm[v]].swap(gi.vertnames[v]);
+    }
+    gi.vertnames.swap(names);
+    return perm;
+}
+
+
+/* see reorder.h */
+template <typename W>
+unique_ptr<BasicGraph<W> > minSpanTreeReordered(const BasicGraph<W>* g, int method){
+    unique_ptr<int[]> perm = vertexOrder(g, method);
+    if(perm == NULL){
+        return minSpanTree(g);
+    }
+    int n = g->numVerts();
+    unique_ptr<BasicGraph<W> > h = permuteGraph(g, perm.get(), LIST);
+    unique_ptr<BasicGraph<W> > tree = minSpanTree(h.get());
+    unique_ptr<int[]> inv = inversePermutation(perm.get(), n);
+    return permuteGraph(tree.get(), inv.get(), ULIST);
+}
+
+
+/* the weight types reorder is compiled for, same as BasicGraph in graph.cpp */
+#define REORDER_INSTANTIATE(W) \
+    template unique_ptr<int[]> vertexOrder<W>(const BasicGraph<W>*, int); \
+    template unique_ptr<BasicGraph<W> > permuteGraph<W>(const BasicGraph<W>*, const int*, int); \
+    template unique_ptr<int[]> reorderGraphInfo<W>(basicgraphinfo<W>&, int); \
+    template unique_ptr<BasicGraph<W> > minSpanTreeReordered<W>(const BasicGraph<W>*, int);
+
+REORDER_INSTANTIATE(float)
+REORDER_INSTANTIATE(double)
+REORDER_INSTANTIATE(uint16_t)
+REORDER_INSTANTIATE(uint32_t)
+REORDER_INSTANTIATE(int64_t)
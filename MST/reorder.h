@@ -0,0 +1,68 @@
+#ifndef REORDER_H
+#define REORDER_H
+
+#include "graph.h"
+#include "graphio.h"
+
+/* Renumbering the vertices of a graph for locality.
+ *
+ * readGraph numbers vertices in file order, which has nothing to do with
+ * the shape of the graph, so the arrays Prim's indexes by vertex (link, inQ,
+ * the handles) are touched all over the place.  Renumbering so that
+ * neighbors get nearby numbers makes those accesses mostly local.
+ *
+ * A permutation is an array perm of length numVerts() where perm[v] is the
+ * new number of the vertex that used to be v.  Permutations and graphs are
+ * returned in unique_ptrs, which own them.
+ *
+ * The orders look at the graph as undirected, through successorEdges(), which
+ * is all that is needed for the symmetric graphs minSpanTree takes.
+ */
+
+#define ORDER_BFS 0     /* breadth first, each component from its lowest vertex */
+#define ORDER_RCM 1     /* reverse Cuthill-McKee: BFS from a minimum degree vertex,
+                           neighbors by increasing degree, whole order reversed */
+#define ORDER_DEGREE 2  /* by decreasing out degree, ties in the old order */
+
+
+/* Return a permutation of the vertices of g in the given order.
+ * If method is not one of the ORDER_ constants, return NULL.
+ */
+template <typename W>
+unique_ptr<int[]> vertexOrder(const BasicGraph<W>* g, int method);
+
+
+/* Return the inverse of the permutation perm of 0 .. n-1,
+ * i.e. inv[perm[v]] == v.
+ */
+unique_ptr<int[]> inversePermutation(const int* perm, int n);
+
+
+/* Return a new graph, in representation rep, with an edge perm[s] -> perm[t]
+ * of weight w for every edge s -> t of weight w in g.
+ * Use inversePermutation(perm) to map a result (a tree, say) back to the
+ * original numbers.
+ */
+template <typename W>
+unique_ptr<BasicGraph<W> > permuteGraph(const BasicGraph<W>* g, const int* perm, int rep);
+
+
+/* Renumber the graph of gi in the given order, in place: gi.graph is
+ * replaced by the permuted graph (same representation; the old one is
+ * deleted), and gi.vertnames is permuted the same way, so every name
+ * stays with its vertex.
+ * Returns the permutation used, so numbers handed out before the call
+ * can be translated, or NULL (and no change) if method is invalid.
+ */
+template <typename W>
+unique_ptr<int[]> reorderGraphInfo(basicgraphinfo<W>& gi, int method);
+
+
+/* minSpanTree of g computed on a copy renumbered in the given order, with
+ * the tree mapped back to the numbering of g.  The result is a tree of g,
+ * just as minSpanTree(g) returns.
+ */
+template <typename W>
+unique_ptr<BasicGraph<W> > minSpanTreeReordered(const BasicGraph<W>* g, int method);
+
+#endif
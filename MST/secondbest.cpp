@@ -0,0 +1,328 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+#include "secondbest.h"
+
+/* IMPLEMENTATION OF secondbest.h */
+
+
+/* see secondbest.h */
+template <typename W>
+TreePaths<W>::TreePaths(const BasicGraph<W>* tree){
+    n = tree->numVerts();
+    levels = 1;
+    while((1 << levels) <= n){
+        levels++;
+    }
+    up = new int[levels * n];
+    top = new int[levels * n];
+    deep = new int[n];
+    above = new W[n];
+
+    //breadth first from the lowest vertex of each component, in up[0 .. n-1]
+    int* queue = new int[n];
+    int* targets = new int[n];
+    W* weights = new W[n];
+    for(int v = 0; v < n; v++){
+        up[v] = -2;
+    }
+    for(int root = 0; root < n; root++){
+        if(up[root] != -2){
+            continue;
+        }
+        up[root] = -1;
+        deep[root] = 0;
+        above[root] = 0;
+        int head = 0, tail = 0;
+        queue[tail++] = root;
+        while(head < tail){
+            int v = queue[head++];
+            int degree = tree->successorEdges(v, targets, weights);
+            for(int index = 0; index < degree; index++){
+                int u = targets[index];
+                if(up[u] == -2){
+                    up[u] = v;
+                    deep[u] = deep[v] + 1;
+                    above[u] = weights[index];
+                    queue[tail++] = u;
+                }
+            }
+        }
+    }
+    delete[] weights;
+    delete[] targets;
+    delete[] queue;
+
+    for(int v = 0; v < n; v++){
+        top[v] = (up[v] == -1) ? -1 : v;
+    }
+    for(int k = 1; k < levels; k++){
+        int* prevUp = up + (k - 1) * n;
+        int* prevTop = top + (k - 1) * n;
+        for(int v = 0; v < n; v++){
+            int mid = prevUp[v];
+            up[k * n + v] = (mid == -1) ? -1 : prevUp[mid];
+            top[k * n + v] = (mid == -1) ? prevTop[v] : heavier(prevTop[v], prevTop[mid]);
+        }
+    }
+}
+
+
+/* see secondbest.h */
+template <typename W>
+TreePaths<W>::~TreePaths(){
+    delete[] up;
+    delete[] top;
+    delete[] deep;
+    delete[] above;
+}
+
+
+/* of the edges above a and b (given by their lower ends), the heavier one;
+ -1 stands for no edge at all */
+template <typename W>
+int TreePaths<W>::heavier(int a, int b){
+    if(a == -1){
+        return b;
+    }
+    if(b == -1){
+        return a;
+    }
+    return (above[b] > above[a]) ? b : a;
+}
+
+
+/* see secondbest.h */
+template <typename W>
+int TreePaths<W>::parent(int v){
+    return up[v];
+}
+
+
+/* see secondbest.h */
+template <typename W>
+W TreePaths<W>::parentWeight(int v){
+    return above[v];
+}
+
+
+/* see secondbest.h */
+template <typename W>
+int TreePaths<W>::depth(int v){
+    return deep[v];
+}
+
+
+/* see secondbest.h */
+template <typename W>
+int TreePaths<W>::ancestor(int u, int v){
+    if(deep[u] < deep[v]){
+        std::swap(u, v);
+    }
+    for(int k = levels - 1; k >= 0; k--){
+        if(deep[u] - (1 << k) >= deep[v]){
+            u = up[k * n + u];
+        }
+    }
+    if(u == v){
+        return u;
+    }
+    for(int k = levels - 1; k >= 0; k--){
+        if(up[k * n + u] != up[k * n + v]){
+            u = up[k * n + u];
+            v = up[k * n + v];
+        }
+    }
+    return (up[u] == up[v]) ? up[u] : -1;
+}
+
+
+/* see secondbest.h */
+template <typename W>
+int TreePaths<W>::maxEdge(int u, int v){
+    if(ancestor(u, v) == -1){
+        return -1;
+    }
+    int best = -1;
+    if(deep[u] < deep[v]){
+        std::swap(u, v);
+    }
+    for(int k = levels - 1; k >= 0; k--){
+        if(deep[u] - (1 << k) >= deep[v]){
+            best = heavier(best, top[k * n + u]);
+            u = up[k * n + u];
+        }
+    }
+    if(u == v){
+        return best;
+    }
+    for(int k = levels - 1; k >= 0; k--){
+        if(up[k * n + u] != up[k * n + v]){
+            best = heavier(best, top[k * n + u]);
+            best = heavier(best, top[k * n + v]);
+            u = up[k * n + u];
+            v = up[k * n + v];
+        }
+    }
+    best = heavier(best, u);
+    return heavier(best, v);
+}
+
+
+/* The edges of g that are not in the tree (each once, lower end first)
+ and the total weight of the tree. */
+template <typename W>
+static double nonTreeEdges(const BasicGraph<W>* g, TreePaths<W>& paths,
+                           std::vector<typename BasicGraph<W>::Edge>& edges){
+    int n = g->numVerts();
+    int* targets = new int[n];
+    W* weights = new W[n];
+    double total = 0;
+    for(int v = 0; v < n; v++){
+        if(paths.parent(v) != -1){
+            total += (double)paths.parentWeight(v);
+        }
+        int degree = g->successorEdges(v, targets, weights);
+        for(int index = 0; index < degree; index++){
+            int u = targets[index];
+            if(u > v && paths.parent(u) != v && paths.parent(v) != u){
+                typename BasicGraph<W>::Edge e = {v, u, weights[index]};
+                edges.push_back(e);
+            }
+        }
+    }
+    delete[] weights;
+    delete[] targets;
+    return total;
+}
+
+
+/* union-find root of v with path halving; free[v] leads from v towards the
+ nearest ancestor whose edge still has no replacement */
+static int nextFree(int* free, int v){
+    while(free[v] != v){
+        free[v] = free[free[v]];
+        v = free[v];
+    }
+    return v;
+}
+
+
+/* see secondbest.h */
+template <typename W>
+vector<basicreplacement<W> > replacementEdges(const BasicGraph<W>* g, const BasicGraph<W>* tree){
+    int n = g->numVerts();
+    TreePaths<W> paths(tree);
+    std::vector<typename BasicGraph<W>::Edge> edges;
+    double total = nonTreeEdges(g, paths, edges);
+    std::stable_sort(edges.begin(), edges.end(),
+                     [](const typename BasicGraph<W>::Edge& a,
+                        const typename BasicGraph<W>::Edge& b){ return a.weight < b.weight; });
+
+    //cover[v] is the non-tree edge replacing v-parent(v), or -1
+    int* cover = new int[n];
+    int* free = new int[n];
+    for(int v = 0; v < n; v++){
+        cover[v] = -1;
+        free[v] = v;
+    }
+    for(int e = 0; e < (int)edges.size(); e++){
+        int lca = paths.ancestor(edges[e].source, edges[e].target);
+        if(lca == -1){
+            continue;
+        }
+        int ends[2] = {edges[e].source, edges[e].target};
+        for(int side = 0; side < 2; side++){
+            int v = nextFree(free, ends[side]);
+            while(paths.depth(v) > paths.depth(lca)){
+                cover[v] = e;
+                free[v] = paths.parent(v);
+                v = nextFree(free, v);
+            }
+        }
+    }
+
+    vector<basicreplacement<W> > result;
+    for(int v = 0; v < n; v++){
+        if(paths.parent(v) == -1){
+            continue;
+        }
+        basicreplacement<W> r;
+        r.source = paths.parent(v);
+        r.target = v;
+        r.weight = paths.parentWeight(v);
+        if(cover[v] == -1){
+            r.replSource = r.replTarget = -1;
+            r.replWeight = WeightTraits<W>::noEdge();
+            r.totalWeight = INFINITY;
+        }else{
+            r.replSource = edges[cover[v]].source;
+            r.replTarget = edges[cover[v]].target;
+            r.replWeight = edges[cover[v]].weight;
+            r.totalWeight = total - (double)r.weight + (double)r.replWeight;
+        }
+        result.push_back(r);
+    }
+    delete[] free;
+    delete[] cover;
+    return result;
+}
+
+
+/* see secondbest.h */
+template <typename W>
+unique_ptr<BasicGraph<W> > secondBestTree(const BasicGraph<W>* g, const BasicGraph<W>* tree,
+                                          double* totalWeight){
+    int n = g->numVerts();
+    TreePaths<W> paths(tree);
+    std::vector<typename BasicGraph<W>::Edge> edges;
+    double total = nonTreeEdges(g, paths, edges);
+
+    //the cheapest swap: a non-tree edge in, the heaviest edge on its tree path out
+    int bestEdge = -1, bestOut = -1;
+    double bestDelta = 0;
+    for(int e = 0; e < (int)edges.size(); e++){
+        int out = paths.maxEdge(edges[e].source, edges[e].target);
+        if(out == -1){
+            continue;
+        }
+        double delta = (double)edges[e].weight - (double)paths.parentWeight(out);
+        if(bestEdge == -1 || delta < bestDelta){
+            bestEdge = e;
+            bestOut = out;
+            bestDelta = delta;
+        }
+    }
+    if(bestEdge == -1){
+        return NULL;
+    }
+
+    std::vector<typename BasicGraph<W>::Edge> kept;
+    for(int v = 0; v < n; v++){
+        if(paths.parent(v) != -1 && v != bestOut){
+            typename BasicGraph<W>::Edge e = {paths.parent(v), v, paths.parentWeight(v)};
+            kept.push_back(e);
+        }
+    }
+    kept.push_back(edges[bestEdge]);
+    unique_ptr<BasicGraph<W> > second(new BasicGraph<W>(n, ULIST));
+    second->addEdges(kept.data(), (int)kept.size(), false);
+    if(totalWeight != NULL){
+        *totalWeight = total + bestDelta;
+    }
+    return second;
+}
+
+
+/* the weight types secondbest is compiled for, same as BasicGraph in graph.cpp */
+#define SECONDBEST_INSTANTIATE(W) \
+    template class TreePaths<W>; \
+    template vector<basicreplacement<W> > replacementEdges<W>(const BasicGraph<W>*, const BasicGraph<W>*); \
+    template unique_ptr<BasicGraph<W> > secondBestTree<W>(const BasicGraph<W>*, const BasicGraph<W>*, double*);
+
+SECONDBEST_INSTANTIATE(float)
+SECONDBEST_INSTANTIATE(double)
+SECONDBEST_INSTANTIATE(uint16_t)
+SECONDBEST_INSTANTIATE(uint32_t)
+SECONDBEST_INSTANTIATE(int64_t)
@@ -0,0 +1,110 @@
+#ifndef SECONDBEST_H
+#define SECONDBEST_H
+
+#include "graph.h"
+#include <vector>
+
+/* What happens to a minimum spanning tree when one of its edges goes away.
+ *
+ * All functions take the graph g given to minSpanTree (symmetric, see
+ * primmst.h) and a minimum spanning tree of it, such as minSpanTree returns
+ * (any representation will do, as long as each tree edge can be seen from
+ * both ends, which is true of the ULIST tree and of a symmetric graph).
+ * If g is not connected, tree is the spanning forest, and everything below
+ * is about the tree of the component an edge is in.
+ *
+ * Removing tree edge e splits the tree in two; the best spanning tree
+ * without e is the old tree minus e plus the lightest non-tree edge that
+ * joins the two halves, the replacement of e.  A non-tree edge u-v joins the
+ * halves exactly when e is on the tree path from u to v.  So the questions
+ * come down to path queries over the tree, which TreePaths answers in
+ * O(log V) each after O(V log V) preparation.
+ */
+
+
+/* The tree edge source-target (source is the parent of target, each tree
+ * rooted at its lowest vertex as in TreePaths) and its replacement: the
+ * cheapest edge of g, not in the tree, that reconnects the tree without it.
+ * If there is none (the edge is a bridge of g) replSource and replTarget are -1, replWeight is
+ * WeightTraits<W>::noEdge() and totalWeight is INFINITY.
+ * totalWeight is the weight of the best spanning tree without the edge.
+ */
+template <typename W>
+struct basicreplacement {
+    int source;
+    int target;
+    W weight;
+    int replSource;
+    int replTarget;
+    W replWeight;
+    double totalWeight;
+};
+typedef basicreplacement<float> Replacement;
+
+
+/* The tree rooted at the lowest vertex of each component, with binary
+ * lifting tables for path queries.  Made once for a tree, then queried
+ * without allocation.
+ */
+template <typename W>
+class TreePaths {
+
+ public:
+
+  /* tree must be a forest; its edge weights are read once, here */
+  TreePaths(const BasicGraph<W>* tree);
+  ~TreePaths();
+
+  /* the parent of v, or -1 if v is a root */
+  int parent(int v);
+
+  /* the weight of the edge from v to its parent (undefined for a root) */
+  W parentWeight(int v);
+
+  /* number of edges between v and its root */
+  int depth(int v);
+
+  /* lowest common ancestor of u and v, or -1 if they are in different trees */
+  int ancestor(int u, int v);
+
+  /* the heaviest edge on the tree path between u and v, given by the lower
+   * of its two ends (so the edge is lower-parent(lower)).
+   * Returns -1 if u == v or they are in different trees.
+   */
+  int maxEdge(int u, int v);
+
+ private:
+  TreePaths(const TreePaths&) = delete;
+  TreePaths& operator=(const TreePaths&) = delete;
+
+  int heavier(int a, int b);   //of the edges above a and b, the heavier (-1 is lightest)
+
+  int n;          //number of vertices
+  int levels;     //number of lifting levels, 2^levels > n
+  int* up;        //up[k*n+v] is the 2^k-th ancestor of v, or -1
+  int* top;       //top[k*n+v] is the heaviest edge on those 2^k edges
+  int* deep;      //deep[v] is the depth of v
+  W* above;       //above[v] is the weight of the edge from v to its parent
+};
+
+
+/* One entry per tree edge, in increasing order of the target vertex.
+ * Takes O(E log V) time: the non-tree edges are sorted by weight and each
+ * tree edge is given to the first one whose tree path covers it, skipping
+ * edges already given away with a union-find structure.
+ */
+template <typename W>
+vector<basicreplacement<W> > replacementEdges(const BasicGraph<W>* g, const BasicGraph<W>* tree);
+
+
+/* The second best spanning tree of g: a spanning tree, other than tree, of
+ * least weight.  It differs from tree by one edge swap (the tree edge whose
+ * replacement costs least), and its weight is put in *totalWeight if that is
+ * not NULL.  Returned as a new ULIST graph, or NULL if tree is the only
+ * spanning tree of g.
+ */
+template <typename W>
+unique_ptr<BasicGraph<W> > secondBestTree(const BasicGraph<W>* g, const BasicGraph<W>* tree,
+                                          double* totalWeight);
+
+#endif
@@ -0,0 +1,99 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include "snapshot.h"
+
+/* IMPLEMENTATION OF snapshot.h */
+
+
+/* see snapshot.h */
+template <typename W>
+VersionedGraph<W>::VersionedGraph(int n, int rep){
+    Snapshot* first = new Snapshot;
+    first->graph = shared_ptr<const BasicGraph<W> >(new BasicGraph<W>(n, rep));
+    first->version = 0;
+    std::atomic_store(&published, shared_ptr<const Snapshot>(first));
+}
+
+
+/* see snapshot.h */
+template <typename W>
+VersionedGraph<W>::VersionedGraph(BasicGraph<W>&& g){
+    Snapshot* first = new Snapshot;
+    first->graph = shared_ptr<const BasicGraph<W> >(new BasicGraph<W>(std::move(g)));
+    first->version = 0;
+    std::atomic_store(&published, shared_ptr<const Snapshot>(first));
+}
+
+
+/* see snapshot.h */
+template <typename W>
+typename VersionedGraph<W>::Snapshot VersionedGraph<W>::snapshot() const{
+    return *std::atomic_load(&published);
+}
+
+
+/* see snapshot.h */
+template <typename W>
+unsigned long long VersionedGraph<W>::version() const{
+    return std::atomic_load(&published)->version;
+}
+
+
+/* the draft, made from the published graph on the first change after a publish.
+ Called with writers held. */
+template <typename W>
+BasicGraph<W>* VersionedGraph<W>::draftForWrite(){
+    if(draft == NULL){
+        shared_ptr<const Snapshot> now = std::atomic_load(&published);
+        draft = now->graph->cloneGraph(now->graph->representation());
+    }
+    return draft.get();
+}
+
+
+/* see snapshot.h */
+template <typename W>
+bool VersionedGraph<W>::addEdge(int source, int target, W w){
+    std::lock_guard<std::mutex> hold(writers);
+    return draftForWrite()->addEdge(source, target, w);
+}
+
+
+/* see snapshot.h */
+template <typename W>
+int VersionedGraph<W>::addEdges(const typename BasicGraph<W>::Edge* batch, int count, bool symmetric){
+    std::lock_guard<std::mutex> hold(writers);
+    return draftForWrite()->addEdges(batch, count, symmetric);
+}
+
+
+/* see snapshot.h */
+template <typename W>
+bool VersionedGraph<W>::delEdge(int source, int target){
+    std::lock_guard<std::mutex> hold(writers);
+    return draftForWrite()->delEdge(source, target);
+}
+
+
+/* see snapshot.h */
+template <typename W>
+unsigned long long VersionedGraph<W>::publish(){
+    std::lock_guard<std::mutex> hold(writers);
+    shared_ptr<const Snapshot> now = std::atomic_load(&published);
+    if(draft == NULL){
+        return now->version;
+    }
+    Snapshot* next = new Snapshot;
+    next->graph = shared_ptr<const BasicGraph<W> >(draft.release());
+    next->version = now->version + 1;
+    std::atomic_store(&published, shared_ptr<const Snapshot>(next));
+    return next->version;
+}
+
+
+/* the weight types VersionedGraph is compiled for, same as BasicGraph in graph.cpp */
+template class VersionedGraph<float>;
+template class VersionedGraph<double>;
+template class VersionedGraph<uint16_t>;
+template class VersionedGraph<uint32_t>;
+template class VersionedGraph<int64_t>;
@@ -0,0 +1,78 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "graph.h"
+#include <memory>
+#include <mutex>
+
+/* A graph that one side changes while others read it.
+ *
+ * The read functions of BasicGraph are const and touch nothing, so any
+ * number of threads may read one graph at once; but nothing may read while
+ * addEdge or delEdge runs.  A VersionedGraph keeps readers and writers apart
+ * with copy-on-write snapshots:
+ *
+ *  - A reader calls snapshot() and gets a const graph in a shared_ptr.  That
+ *    graph never changes, so the reader can run minSpanTree or any other
+ *    const analysis on it for as long as it likes, with no locking.
+ *  - A writer's addEdge/delEdge go to a private draft.  The first change
+ *    after a publish copies the published graph into the draft (cloneGraph,
+ *    O(V + E)); later changes go straight to the draft.
+ *  - publish() makes the draft the new published graph, with the next
+ *    version number, in O(1).  Snapshots taken before keep the old graph
+ *    alive until the last of them is dropped.
+ *
+ * Taking a snapshot is one std::atomic_load of a shared_ptr (the standard
+ * library may guard that with an internal lock held for a few instructions,
+ * never while a graph is copied or changed).  Writers take a mutex among
+ * themselves, which readers never wait on.
+ */
+
+template <typename W>
+class VersionedGraph {
+
+ public:
+
+  /* A consistent view: graph is the published graph of the given version. */
+  struct Snapshot {
+    shared_ptr<const BasicGraph<W> > graph;
+    unsigned long long version;
+  };
+
+  /* start with an empty graph of n vertices in representation rep, version 0 */
+  VersionedGraph(int n, int rep);
+
+  /* start with g (taken over), version 0 */
+  explicit VersionedGraph(BasicGraph<W>&& g);
+
+  /* the published graph and its version; safe from any thread */
+  Snapshot snapshot() const;
+
+  /* the version of the published graph */
+  unsigned long long version() const;
+
+  /* change the draft, as the BasicGraph functions of the same name;
+   * nothing is visible to snapshot() until publish()
+   */
+  bool addEdge(int source, int target, W w);
+  int addEdges(const typename BasicGraph<W>::Edge* batch, int count, bool symmetric);
+  bool delEdge(int source, int target);
+
+  /* Publish the draft as the next version and return that version.
+   * Without changes since the last publish, nothing happens and the
+   * current version is returned.
+   */
+  unsigned long long publish();
+
+ private:
+  VersionedGraph(const VersionedGraph&) = delete;
+  VersionedGraph& operator=(const VersionedGraph&) = delete;
+
+  BasicGraph<W>* draftForWrite();  //the draft, copied from published if need be
+
+  shared_ptr<const Snapshot> published;  //read and replaced atomically
+  unique_ptr<BasicGraph<W> > draft;     //the writers' copy, or NULL if unchanged
+  mutable std::mutex writers;           //held by addEdge, delEdge and publish
+};
+
+#endif
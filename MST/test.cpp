@@ -1,7 +1,11 @@
 #include "primmst.h"
+#include "multiprio.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 /* Do NOT test Prim's MST algorithm from this test file
  * Only test your priority queue.
@@ -28,21 +32,72 @@ bool run_test(int test_number) {
     break;
   }
 
-    /*
   case 4: {
-    // test04 : (description here)
-    (implementation here)
-    break; // if your test suceeds, break
+    // test04 : MultiPrio from 8 threads at once; every item comes out exactly once
+    const int threads = 8, per = 20000, n = threads * per;
+    MultiPrio q(n, 16);
+    double* last = new double[n];
+    std::atomic<int>* seen = new std::atomic<int>[n];
+    std::atomic<bool> bad(false);
+    std::atomic<int> arrived(0);
+    for (int i = 0; i < n; i++) seen[i].store(0);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; t++) {
+      pool.push_back(std::thread([&, t]() {
+        unsigned int r = 12345 + t;
+        for (int i = t * per; i < (t + 1) * per; i++) {
+          r = r * 1103515245 + 12345;
+          last[i] = (double)(r % 100000);
+          if (!q.enqueue(i, last[i]) || q.enqueue(i, last[i])) bad = true;
+        }
+        for (int i = t * per; i < (t + 1) * per; i += 3) {
+          // nothing is dequeued yet, so this always lowers the key
+          if (!q.decreasedKey(i, last[i] - 1)) bad = true;
+        }
+        // nobody dequeues until all have enqueued, or a second enqueue of an
+        // item already taken out would rightly succeed
+        arrived++;
+        while (arrived.load() < threads) std::this_thread::yield();
+        double key;
+        int item;
+        while ((item = q.dequeueMin(&key)) != -1) {
+          if (item < 0 || item >= n) bad = true;
+          else seen[item]++;
+        }
+      }));
+    }
+    for (int t = 0; t < threads; t++) pool[t].join();
+    for (int i = 0; i < n; i++) {
+      if (seen[i].load() != 1) bad = true;
+    }
+    delete[] seen;
+    delete[] last;
+    if (bad || q.nonempty() || q.size() != 0) return false;
+    break;
   }
-    */
 
-     /*
   case 5: {
-    // test05 : (description here)
-    (implementation here)
-    break; // if your test suceeds, break
+    // test05 : MultiPrio with one heap is an exact priority queue, decreasedKey included
+    const int n = 1000;
+    MultiPrio q(n, 1);
+    if (q.numQueues() != 1 || q.dequeueMin(NULL) != -1) return false;
+    if (q.enqueue(-1, 1) || q.enqueue(n, 1) || q.enqueue(0, INFINITY)) return false;
+    for (int i = 0; i < n; i++) {
+      if (!q.enqueue(i, (double)((i * 7919) % n) + 1000)) return false;
+    }
+    for (int i = 0; i < n; i += 2) {
+      if (!q.decreasedKey(i, (double)((i * 7919) % n))) return false;
+    }
+    if (q.decreasedKey(0, 5000)) return false;
+    double previous = -1, key;
+    for (int i = 0; i < n; i++) {
+      int item = q.dequeueMin(&key);
+      if (item == -1 || key < previous) return false;
+      previous = key;
+    }
+    if (q.nonempty() || q.dequeueMin(NULL) != -1 || q.decreasedKey(3, 0)) return false;
+    break;
   }
-    */
 
   default: {
     printf("ERROR! Test number %d was not found!\n", test_number);
@@ -4,8 +4,9 @@
 
 baseName=prims
 
-# if you make any other files, include them here, but don't include test.cpp
-g++ primTest.c minprio.cpp graph.cpp graphio.c primmst.cpp -o "${baseName}" 
+# if you make any other files, include them here, but don't include test.cpp, engineTest.cpp, graphTest.cpp, calibrate.cpp, multibench.cpp or distbench.cpp
+sources="minprio.cpp bucketprio.cpp graph.cpp graphio.c primmst.cpp reorder.cpp secondbest.cpp cluster.cpp euclid.cpp compressed.cpp builder.cpp snapshot.cpp dispatch.cpp parallelprim.cpp multiprio.cpp distmst.cpp"
+g++ primTest.c ${sources} -pthread -o "${baseName}" 
 if [ $? -ne 0 ]; then
 	echo "Program Did Not Compile"
 else
@@ -13,4 +14,20 @@ else
 	do
 		./"${baseName}" "$f"
 	done
-fi
\ No newline at end of file
+fi
+
+# the other MST engines against minSpanTree, on random graphs
+g++ engineTest.cpp ${sources} -pthread -o engineTest
+if [ $? -ne 0 ]; then
+	echo "Engine Checks Did Not Compile"
+else
+	./engineTest
+fi
+
+# graph storage and output against plain BasicGraphs
+g++ graphTest.cpp ${sources} -pthread -o graphTest
+if [ $? -ne 0 ]; then
+	echo "Graph Checks Did Not Compile"
+else
+	./graphTest
+fi